@@ -5,6 +5,7 @@
 #include <CesiumGeospatial/GlobeTransforms.h>
 #include <CesiumUtility/Math.h>
 
+#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/trigonometric.hpp>
 
 #include <godot_cpp/classes/camera3d.hpp>
@@ -26,37 +27,26 @@ namespace CesiumForGodot
     namespace
     {
 
-        ViewState godotCameraToViewState( const LocalHorizontalCoordinateSystem *pCoordinateSystem,
-                                          const glm::dmat4 &godotWorldToTileset,
-                                          const godot::Camera3D *camera,
-                                          const godot::Size2 viewportSize )
+        ViewState godotCameraToViewState( const glm::dmat4 &godotWorldToEcef,
+                                          const CameraView &view )
         {
-            godot::Transform3D transform = camera->get_camera_transform();
+            const godot::Transform3D &transform = view.transform;
             godot::Vector3 origin = transform.get_origin();
+            godot::Vector3 cameraDirectionGodot = -transform.basis.get_column( 2 ); // column major
+            godot::Vector3 cameraUpGodot = transform.basis.get_column( 1 );
 
             glm::dvec3 cameraPosition =
-                glm::dvec3( godotWorldToTileset * glm::dvec4( origin.x, origin.y, origin.z, 1.0 ) );
-
-            godot::Vector3 cameraDirectionGodot = -transform.basis.get_column( 2 ); // column major
+                glm::dvec3( godotWorldToEcef * glm::dvec4( origin.x, origin.y, origin.z, 1.0 ) );
             glm::dvec3 cameraDirection = glm::dvec3(
-                godotWorldToTileset * glm::dvec4( cameraDirectionGodot.x, cameraDirectionGodot.y,
-                                                  cameraDirectionGodot.z, 0.0 ) );
-
-            godot::Vector3 cameraUpGodot = transform.basis.get_column( 1 );
+                godotWorldToEcef * glm::dvec4( cameraDirectionGodot.x, cameraDirectionGodot.y,
+                                               cameraDirectionGodot.z, 0.0 ) );
             glm::dvec3 cameraUp =
-                glm::dvec3( godotWorldToTileset *
+                glm::dvec3( godotWorldToEcef *
                             glm::dvec4( cameraUpGodot.x, cameraUpGodot.y, cameraUpGodot.z, 0.0 ) );
 
-            if ( pCoordinateSystem != nullptr )
-            {
-                cameraPosition = pCoordinateSystem->localPositionToEcef( cameraPosition );
-                cameraDirection = pCoordinateSystem->localDirectionToEcef( cameraDirection );
-                cameraUp = pCoordinateSystem->localDirectionToEcef( cameraUp );
-            }
-
-            double verticalFOV = CesiumUtility::Math::degreesToRadians( camera->get_fov() );
-            double width = viewportSize.width;
-            double height = viewportSize.height;
+            double verticalFOV = view.verticalFOV;
+            double width = view.viewportSize.width;
+            double height = view.viewportSize.height;
             double horizontalFOV = 2 * glm::atan( width / height * glm::tan( verticalFOV * 0.5 ) );
 
             return ViewState::create( cameraPosition, glm::normalize( cameraDirection ),
@@ -64,98 +54,55 @@ namespace CesiumForGodot
                                       horizontalFOV, verticalFOV );
         }
 
-        glm::dmat4 godotTransform3DToGlm( godot::Transform3D transform )
+        void addCameraView( std::vector<CameraView> &views, const godot::Viewport *viewport )
         {
-            // Transform3D basis is column major
-            godot::Basis basis = transform.basis;
-            godot::Vector3 translation = transform.origin;
-
-            glm::mat3 glmBasis( basis[0][0], basis[1][0], basis[2][0], basis[0][1], basis[1][1],
-                                basis[2][1], basis[0][2], basis[1][2], basis[2][2] );
-
-            glm::vec3 glmTranslation( translation.x, translation.y, translation.z );
-            glm::mat4 glmMat4( glmBasis );
-            glmMat4[3] = glm::vec4( glmTranslation, 1.0f );
-
-            glm::dmat4 glmDmat4;
-            for ( int i = 0; i < 4; ++i )
+            godot::Camera3D *camera = viewport->get_camera_3d();
+            if ( camera == nullptr )
             {
-                for ( int j = 0; j < 4; ++j )
-                {
-                    glmDmat4[i][j] = static_cast<double>( glmMat4[i][j] );
-                }
+                return;
             }
-
-            return glmDmat4;
-        }
-
-    } // namespace
-
-    std::vector<ViewState> CameraManager::getAllCameras( const Cesium3DTileset &tileset )
-    {
-        const LocalHorizontalCoordinateSystem *pCoordinateSystem = nullptr;
-
-        glm::dmat4 godotWorldToTileset = godotTransform3DToGlm( tileset.get_transform() );
-
-        Node *parent = tileset.get_parent();
-        if ( parent )
-        {
-            CesiumGeoreference *georeference = Object::cast_to<CesiumGeoreference>( parent );
-            if ( georeference )
+            godot::Size2 viewportSize = viewport->get_visible_rect().size;
+            if ( viewportSize.width > 50 && viewportSize.height > 50 )
             {
-                const LocalHorizontalCoordinateSystem coordinateSystem =
-                    georeference->getCoordinateSystem();
-                pCoordinateSystem = &coordinateSystem;
+                views.push_back( { camera->get_camera_transform(),
+                                   CesiumUtility::Math::degreesToRadians( camera->get_fov() ),
+                                   viewportSize } );
             }
         }
-        else
-        {
-            SPDLOG_ERROR( "Cesium3DTilset Node must be the subnode of CesiumGeoreference" );
-        }
 
-        std::vector<ViewState> result;
-        godot::Camera3D *currentCamera = nullptr;
-        godot::Viewport *viewport = tileset.get_viewport();
-        if ( viewport != nullptr )
+        glm::dmat4 godotTransform3DToGlm( const godot::Transform3D &transform )
         {
-            currentCamera = viewport->get_camera_3d();
+            // Transform3D basis is row major. Converted straight to double, so no precision is
+            // lost on the way.
+            const godot::Basis &basis = transform.basis;
+            const godot::Vector3 &translation = transform.origin;
+            return glm::dmat4( glm::dvec4( basis[0][0], basis[1][0], basis[2][0], 0.0 ),
+                               glm::dvec4( basis[0][1], basis[1][1], basis[2][1], 0.0 ),
+                               glm::dvec4( basis[0][2], basis[1][2], basis[2][2], 0.0 ),
+                               glm::dvec4( translation.x, translation.y, translation.z, 1.0 ) );
         }
 
-        if ( currentCamera != nullptr )
+    } // namespace
+
+    std::vector<CameraView> CameraManager::getAllCameraViews( const godot::Viewport *viewport )
+    {
+        std::vector<CameraView> result;
+        if ( viewport != nullptr )
         {
-            godot::Size2 viewportSize = viewport->get_visible_rect().size;
-            if ( viewportSize.width > 50 && viewportSize.height > 50 )
-            {
-                result.emplace_back( godotCameraToViewState( pCoordinateSystem, godotWorldToTileset,
-                                                             currentCamera, viewportSize ) );
-            }
+            addCameraView( result, viewport );
         }
 
         if ( godot::Engine::get_singleton()->is_editor_hint() )
         {
-
             EditorInterface *editor_interface = EditorInterface::get_singleton();
-            Node *editor_root_node = editor_interface->get_edited_scene_root();
-            godot::SubViewport *editor_viewport = nullptr;
-            godot::Camera3D *editor_camera = nullptr;
 
             std::array<int, 4> indices{ 0, 1, 2, 3 };
             for ( int i : indices )
             {
-                editor_viewport = editor_interface->get_editor_viewport_3d( i );
+                godot::SubViewport *editor_viewport = editor_interface->get_editor_viewport_3d( i );
                 if ( editor_viewport != nullptr )
                 {
-                    editor_camera = editor_viewport->get_camera_3d();
-                    if ( editor_camera != nullptr )
-                    {
-                        godot::Size2 viewportSize = editor_viewport->get_visible_rect().size;
-                        if ( viewportSize.width > 50 && viewportSize.height > 50 )
-                        {
-                            result.emplace_back(
-                                godotCameraToViewState( pCoordinateSystem, godotWorldToTileset,
-                                                        editor_camera, viewportSize ) );
-                        }
-                    }
+                    addCameraView( result, editor_viewport );
                 }
             }
         }
@@ -163,4 +110,34 @@ namespace CesiumForGodot
         return result;
     }
 
+    std::vector<ViewState> CameraManager::toViewStates( const Cesium3DTileset &tileset,
+                                                        const std::vector<CameraView> &views )
+    {
+        // Godot world -> tileset -> georeference local -> ECEF, all in double precision. The
+        // coordinate system is the georeference's cached one, rebuilt only when it changes.
+        glm::dmat4 godotWorldToEcef =
+            glm::affineInverse( godotTransform3DToGlm( tileset.get_global_transform() ) );
+
+        CesiumGeoreference *georeference =
+            Object::cast_to<CesiumGeoreference>( tileset.get_parent() );
+        if ( georeference )
+        {
+            godotWorldToEcef =
+                georeference->getCoordinateSystem().getLocalToEcefTransformation() *
+                godotWorldToEcef;
+        }
+        else
+        {
+            SPDLOG_ERROR( "Cesium3DTilset Node must be the subnode of CesiumGeoreference" );
+        }
+
+        std::vector<ViewState> result;
+        result.reserve( views.size() );
+        for ( const CameraView &view : views )
+        {
+            result.emplace_back( godotCameraToViewState( godotWorldToEcef, view ) );
+        }
+        return result;
+    }
+
 } // namespace CesiumForGodot
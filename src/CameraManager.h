@@ -8,14 +8,35 @@
 
 #include "Cesium3DTileset.h"
 
+#include <godot_cpp/classes/viewport.hpp>
+
 namespace CesiumForGodot
 {
 
+    /**
+     * A camera as seen from Godot world space, before it is converted for a tileset.
+     */
+    struct CameraView
+    {
+        godot::Transform3D transform;
+        double verticalFOV;
+        godot::Size2 viewportSize;
+    };
+
     class CameraManager
     {
     public:
-        static std::vector<Cesium3DTilesSelection::ViewState> getAllCameras(
-            const Cesium3DTileset &tileset );
+        /**
+         * The cameras looking into a viewport's world: its current camera and, in the editor,
+         * those of the 3D editor viewports.
+         */
+        static std::vector<CameraView> getAllCameraViews( const godot::Viewport *viewport );
+
+        /**
+         * Converts cameras from Godot world space to the tileset's ECEF view states.
+         */
+        static std::vector<Cesium3DTilesSelection::ViewState> toViewStates(
+            const Cesium3DTileset &tileset, const std::vector<CameraView> &views );
     };
 
 } // namespace CesiumForGodot
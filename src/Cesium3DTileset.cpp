@@ -1,5 +1,6 @@
 #include "Cesium3DTileset.h"
-#include "CameraManager.h"
+#include "CesiumTilesetManager.h"
+#include "GodotAssetAccessor.h"
 #include "GodotPrepareRendererResources.h"
 #include "GodotTilesetExternals.h"
 
@@ -12,10 +13,13 @@
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/sub_viewport.hpp>
 #include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/classes/world3d.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/templates/vector.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <algorithm>
+
 using namespace godot;
 using namespace CesiumForGodot;
 using namespace Cesium3DTilesSelection;
@@ -127,9 +131,39 @@ void Cesium3DTileset::_bind_methods()
     ADD_PROPERTY( PropertyInfo( Variant::BOOL, "generate smooth normals" ),
                   "set_generate_smooth_normals", "get_generate_smooth_normals" );
 
-    ClassDB::bind_method( D_METHOD( "get_log_selection_stats" ), &Cesium3DTileset::get_log_selection_stats );
-    ClassDB::bind_method( D_METHOD( "set_log_selection_stats", "p_log_selection_stats" ), &Cesium3DTileset::set_log_selection_stats );
-    ADD_PROPERTY( PropertyInfo( Variant::BOOL, "log selection stats"), "set_log_selection_stats", "get_log_selection_stats" );
+    ClassDB::bind_method( D_METHOD( "get_use_rendering_server_instances" ),
+                          &Cesium3DTileset::get_use_rendering_server_instances );
+    ClassDB::bind_method(
+        D_METHOD( "set_use_rendering_server_instances", "p_use_rendering_server_instances" ),
+        &Cesium3DTileset::set_use_rendering_server_instances );
+    ADD_PROPERTY( PropertyInfo( Variant::BOOL, "use rendering server instances" ),
+                  "set_use_rendering_server_instances", "get_use_rendering_server_instances" );
+
+    ClassDB::bind_method( D_METHOD( "get_main_thread_time_budget" ),
+                          &Cesium3DTileset::get_main_thread_time_budget );
+    ClassDB::bind_method( D_METHOD( "set_main_thread_time_budget", "p_main_thread_time_budget" ),
+                          &Cesium3DTileset::set_main_thread_time_budget );
+    ADD_PROPERTY( PropertyInfo( Variant::FLOAT, "main thread time budget", PROPERTY_HINT_RANGE,
+                                "0,100,0.5,or_greater,suffix:ms" ),
+                  "set_main_thread_time_budget", "get_main_thread_time_budget" );
+
+    ClassDB::bind_method( D_METHOD( "get_physics_radius" ), &Cesium3DTileset::get_physics_radius );
+    ClassDB::bind_method( D_METHOD( "set_physics_radius", "p_physics_radius" ),
+                          &Cesium3DTileset::set_physics_radius );
+    ADD_PROPERTY( PropertyInfo( Variant::FLOAT, "physics radius", PROPERTY_HINT_RANGE,
+                                "0,10000,1,or_greater,suffix:m" ),
+                  "set_physics_radius", "get_physics_radius" );
+    ClassDB::bind_method( D_METHOD( "add_physics_anchor", "p_anchor" ),
+                          &Cesium3DTileset::add_physics_anchor );
+    ClassDB::bind_method( D_METHOD( "remove_physics_anchor", "p_anchor" ),
+                          &Cesium3DTileset::remove_physics_anchor );
+
+    ClassDB::bind_method( D_METHOD( "get_log_selection_stats" ),
+                          &Cesium3DTileset::get_log_selection_stats );
+    ClassDB::bind_method( D_METHOD( "set_log_selection_stats", "p_log_selection_stats" ),
+                          &Cesium3DTileset::set_log_selection_stats );
+    ADD_PROPERTY( PropertyInfo( Variant::BOOL, "log selection stats" ), "set_log_selection_stats",
+                  "get_log_selection_stats" );
 
     ClassDB::bind_method( D_METHOD( "load_tileset" ), &Cesium3DTileset::load_tileset );
     ClassDB::bind_method( D_METHOD( "focus_tileset" ), &Cesium3DTileset::focus_tileset );
@@ -145,12 +179,16 @@ Cesium3DTileset::Cesium3DTileset() :
     maximum_cached_mbytes( 512 ), loading_descendant_limit( 20 ), enable_frustum_culling( true ),
     enable_fog_culling( true ), enforce_culled_screen_space_error( true ),
     culled_screen_space_error( 64.0f ), suspend_update( false ), create_physics_meshes( true ),
-    generate_smooth_normals( false ), log_selection_stats( false ), last_opaque_material_hash( 0 ),
+    generate_smooth_normals( false ), use_rendering_server_instances( false ),
+    main_thread_time_budget( 10.0f ), physics_radius( 1000.0f ), log_selection_stats( false ),
     load_progress( 0.0f ), active_loading( false ), tiles_destroyed(false)
 {
 }
 
-Cesium3DTileset::~Cesium3DTileset(){}
+Cesium3DTileset::~Cesium3DTileset()
+{
+    CesiumTilesetManager::get().unregisterTileset( this );
+}
 
 const CesiumGeoreference *Cesium3DTileset::resolve_georeference() const
 {
@@ -179,45 +217,21 @@ const CesiumGeospatial::LocalHorizontalCoordinateSystem *Cesium3DTileset::get_ge
 void Cesium3DTileset::load_tileset()
 {
     TilesetOptions options{};
-    options.maximumScreenSpaceError = this->maximum_screen_space_error;
-    options.preloadAncestors = this->preload_ancestors;
-    options.preloadSiblings = this->preload_siblings;
-    options.forbidHoles = this->forbid_holes;
-    options.maximumSimultaneousTileLoads = this->maximum_simultaneous_tile_loads;
-    options.maximumCachedBytes = this->maximum_cached_mbytes * 1024 * 1024;
-    options.loadingDescendantLimit = this->loading_descendant_limit;
-    options.enableFrustumCulling = this->enable_frustum_culling;
-    options.enableFogCulling = this->enable_fog_culling;
-    options.enforceCulledScreenSpaceError = this->enforce_culled_screen_space_error;
-    options.culledScreenSpaceError = this->culled_screen_space_error;
+    this->write_tileset_options( options );
     options.loadErrorCallback = []( const TilesetLoadFailureDetails &details ) {
         uint16_t statusCode = details.statusCode;
         std::string message = details.message;
         godot::StringName message_( message.c_str() );
         UtilityFunctions::printerr( "Error message: ", message_, " status code: ", statusCode );
     };
-    options.mainThreadLoadingTimeLimit = 5.0;
-    options.tileCacheUnloadTimeLimit = 5.0;
 
     TilesetContentOptions contentOptions{};
     contentOptions.generateMissingNormalsSmooth = this->generate_smooth_normals;
 
-    CesiumGltf::SupportedGpuCompressedPixelFormats supportedFormats;
-    supportedFormats.ETC2_RGBA = true;
-    supportedFormats.ETC1_RGB = true;
-    supportedFormats.BC1_RGB = true;
-    supportedFormats.BC3_RGBA = true;
-    supportedFormats.BC4_R = true;
-    supportedFormats.BC5_RG = true;
-    supportedFormats.BC7_RGBA = true;
-    supportedFormats.ASTC_4x4_RGBA = true;
-    supportedFormats.PVRTC1_4_RGB = true;
-    supportedFormats.PVRTC1_4_RGBA = true;
-    supportedFormats.ETC2_EAC_R11 = true;
-    supportedFormats.ETC2_EAC_RG11 = true;
-
+    // KTX2/Basis textures are transcoded to the best format the GPU supports, or to
+    // uncompressed RGBA when it supports none of them.
     contentOptions.ktx2TranscodeTargets =
-        CesiumGltf::Ktx2TranscodeTargets( supportedFormats, false );
+        CesiumGltf::Ktx2TranscodeTargets( getSupportedGpuCompressedPixelFormats(), false );
     contentOptions.applyTextureTransform = false;
     options.contentOptions = contentOptions;
 
@@ -243,6 +257,12 @@ void Cesium3DTileset::destroy_tileset()
         return;
     }
     this->p_tileset.reset();
+    this->p_view_update_result = nullptr;
+    this->last_view_states.clear();
+    this->rendered_tiles.clear();
+    this->shown_nodes.clear();
+    this->collision_nodes.clear();
+    this->collision_dirty = true;
 }
 
 namespace
@@ -399,20 +419,95 @@ void Cesium3DTileset::update_load_status()
     }
 }
 
-void Cesium3DTileset::update_tileset_options_from_properties()
+void Cesium3DTileset::write_tileset_options( TilesetOptions &options ) const
 {
-    Cesium3DTilesSelection::TilesetOptions &options = this->p_tileset->getOptions();
     options.maximumScreenSpaceError = this->maximum_screen_space_error;
     options.preloadAncestors = this->preload_ancestors;
     options.preloadSiblings = this->preload_siblings;
     options.forbidHoles = this->forbid_holes;
-    options.maximumSimultaneousTileLoads = this->maximum_simultaneous_tile_loads;
-    options.maximumCachedBytes = this->maximum_cached_mbytes * 1024 * 1024;
+    // The tileset's own limits, lowered to its share of the scene-wide budgets if it has one.
+    unsigned int tileLoads = this->maximum_simultaneous_tile_loads;
+    unsigned int cachedMbytes = this->maximum_cached_mbytes;
+    if ( this->shared_tile_loads > 0 )
+    {
+        tileLoads = std::min( tileLoads, this->shared_tile_loads );
+    }
+    if ( this->shared_cached_mbytes > 0 )
+    {
+        cachedMbytes = std::min( cachedMbytes, this->shared_cached_mbytes );
+    }
+    options.maximumSimultaneousTileLoads = tileLoads;
+    options.maximumCachedBytes = int64_t( cachedMbytes ) * 1024 * 1024;
     options.loadingDescendantLimit = this->loading_descendant_limit;
     options.enableFrustumCulling = this->enable_frustum_culling;
     options.enableFogCulling = this->enable_fog_culling;
     options.enforceCulledScreenSpaceError = this->enforce_culled_screen_space_error;
     options.culledScreenSpaceError = this->culled_screen_space_error;
+    // Half of the budget goes to finishing tile loads and half to unloading cached tiles; tiles
+    // that don't fit are left for the next frames. Zero removes the limit.
+    options.mainThreadLoadingTimeLimit = this->main_thread_time_budget / 2.0;
+    options.tileCacheUnloadTimeLimit = this->main_thread_time_budget / 2.0;
+}
+
+void Cesium3DTileset::push_tileset_options()
+{
+    // Called by the setters, once per change. The next update runs the selection traversal,
+    // which applies the options, e.g. evicts tiles beyond a lowered cache size.
+    if ( this->p_tileset )
+    {
+        this->write_tileset_options( this->p_tileset->getOptions() );
+        this->options_changed = true;
+    }
+}
+
+namespace
+{
+    bool isSameViewState( const ViewState &a, const ViewState &b )
+    {
+        return a.getPosition() == b.getPosition() && a.getDirection() == b.getDirection() &&
+               a.getUp() == b.getUp() && a.getViewportSize() == b.getViewportSize() &&
+               a.getHorizontalFieldOfView() == b.getHorizontalFieldOfView() &&
+               a.getVerticalFieldOfView() == b.getVerticalFieldOfView();
+    }
+} // namespace
+
+bool Cesium3DTileset::update_view_inputs( const std::vector<ViewState> &viewStates )
+{
+    const Transform3D globalTransform = this->get_global_transform();
+    const CesiumGeoreference *georeference = this->resolve_georeference();
+    const uint64_t georeferenceVersion = georeference ? georeference->getVersion() : 0;
+
+    bool changed = viewStates.size() != this->last_view_states.size() ||
+                   globalTransform != this->last_global_transform ||
+                   georeference != this->last_georeference ||
+                   georeferenceVersion != this->last_georeference_version;
+    for ( size_t i = 0; !changed && i < viewStates.size(); ++i )
+    {
+        changed = !isSameViewState( viewStates[i], this->last_view_states[i] );
+    }
+
+    if ( changed )
+    {
+        this->last_view_states = viewStates;
+        this->last_global_transform = globalTransform;
+        this->last_georeference = georeference;
+        this->last_georeference_version = georeferenceVersion;
+    }
+    return changed;
+}
+
+bool Cesium3DTileset::has_pending_tile_work( const ViewUpdateResult &updateResult ) const
+{
+    // Explicit counts: computeLoadProgress is a float ratio, which rounds to 100% in very large
+    // tilesets while a few tiles are still loading.
+    return !this->p_tileset->getRootTile() || updateResult.workerThreadTileLoadQueueLength > 0 ||
+           updateResult.mainThreadTileLoadQueueLength > 0 || updateResult.tilesKicked > 0 ||
+           updateResult.tilesWaitingForOcclusionResults > 0 ||
+           !updateResult.tilesFadingOut.empty() ||
+           // Loads in flight finished since, and their tiles are picked up by a traversal.
+           this->p_tileset->getNumberOfTilesLoaded() != this->traversal_tiles_loaded ||
+           // Cached tiles are only unloaded during a traversal.
+           this->p_tileset->getTotalDataBytes() > this->p_tileset->getOptions().maximumCachedBytes;
 }
 
 void Cesium3DTileset::update_last_view_update_result_state(
@@ -455,11 +550,23 @@ void Cesium3DTileset::_notification( int p_what )
 {
     switch ( p_what )
     {
+        case NOTIFICATION_ENTER_TREE:
+            CesiumTilesetManager::get().registerTileset( this );
+            break;
+        case NOTIFICATION_EXIT_TREE:
+            CesiumTilesetManager::get().unregisterTileset( this );
+            break;
         case NOTIFICATION_READY:
             set_process( true );
+            set_notify_transform( true );
+            break;
+        case NOTIFICATION_TRANSFORM_CHANGED:
+        case NOTIFICATION_VISIBILITY_CHANGED:
+            update_tile_server_objects();
             break;
         case NOTIFICATION_PROCESS:
-            update( get_process_delta_time() );
+            // The first tileset to process in a frame updates all of them.
+            CesiumTilesetManager::get().update( get_process_delta_time() );
             break;
         case NOTIFICATION_PREDELETE:
             // UtilityFunctions::print("Cesium3DTileset is being deleted");
@@ -469,6 +576,32 @@ void Cesium3DTileset::_notification( int p_what )
     }
 }
 
+void Cesium3DTileset::update_tile_server_objects()
+{
+    // Tile nodes follow the tileset by themselves; RenderingServer instances and physics bodies
+    // have to be told.
+    if ( !this->p_tileset || !this->is_inside_tree() )
+    {
+        return;
+    }
+
+    const Transform3D tilesetTransform = this->get_global_transform();
+    const bool tilesetVisible = this->is_visible_in_tree();
+    this->p_tileset->forEachLoadedTile( [&]( Tile &tile ) {
+        const TileRenderContent *pRenderContent = tile.getContent().getRenderContent();
+        if ( !pRenderContent )
+        {
+            return;
+        }
+        CesiumGltfNode *pCesiumGltfNode =
+            static_cast<CesiumGltfNode *>( pRenderContent->getRenderResources() );
+        if ( pCesiumGltfNode )
+        {
+            pCesiumGltfNode->update_server_objects( tilesetTransform, tilesetVisible );
+        }
+    } );
+}
+
 void Cesium3DTileset::update( double delta )
 {
 
@@ -485,56 +618,178 @@ void Cesium3DTileset::update( double delta )
         }
     }
 
-    this->update_tileset_options_from_properties();
+    const bool optionsChanged = this->options_changed;
+    this->options_changed = false;
 
-    std::vector<ViewState> viewStates = CameraManager::getAllCameras( *this );
-    const ViewUpdateResult &updateResult =
-        this->p_tileset->updateView( viewStates, static_cast<float>( delta ) );
+    // The selection traversal only runs when something could change its outcome: a view, the
+    // tileset transform, the georeference or the options moved, or tiles are still loading,
+    // unloading or fading. Otherwise the previous result still holds.
+    std::vector<ViewState> viewStates = CesiumTilesetManager::get().getViewStates( *this );
+    const bool viewChanged = this->update_view_inputs( viewStates );
+
+    // Continuations of finished requests and tile loads, which updateView would otherwise run
+    // first thing. Running them here lets has_pending_tile_work see loads that just finished.
+    this->p_tileset->getAsyncSystem().dispatchMainThreadTasks();
+    if ( !this->p_view_update_result || optionsChanged || viewChanged ||
+         this->has_pending_tile_work( *this->p_view_update_result ) )
+    {
+        this->p_view_update_result =
+            &this->p_tileset->updateView( viewStates, static_cast<float>( delta ) );
+        this->traversal_tiles_loaded = this->p_tileset->getNumberOfTilesLoaded();
+    }
+    const ViewUpdateResult &updateResult = *this->p_view_update_result;
 
     this->update_last_view_update_result_state( updateResult );
 
-    for ( auto pTile : updateResult.tilesFadingOut )
+    this->update_visibility( updateResult );
+
+    this->update_collision( updateResult );
+
+    this->update_load_status();
+}
+
+void Cesium3DTileset::update_visibility( const ViewUpdateResult &updateResult )
+{
+    // With a steady view the same tiles are rendered frame after frame, and nothing changes.
+    if ( updateResult.tilesToRenderThisFrame == this->rendered_tiles )
+    {
+        return;
+    }
+    this->rendered_tiles = updateResult.tilesToRenderThisFrame;
+    this->collision_dirty = true;
+
+    std::unordered_set<CesiumGltfNode *> shownNodes;
+    shownNodes.reserve( this->rendered_tiles.size() );
+    for ( auto pTile : this->rendered_tiles )
     {
         if ( pTile->getState() != TileLoadState::Done )
         {
             continue;
         }
+        const TileRenderContent *pRenderContent = pTile->getContent().getRenderContent();
+        CesiumGltfNode *pCesiumGltfNode =
+            pRenderContent ? static_cast<CesiumGltfNode *>( pRenderContent->getRenderResources() )
+                           : nullptr;
+        if ( pCesiumGltfNode )
+        {
+            shownNodes.insert( pCesiumGltfNode );
+        }
+    }
 
-        const Cesium3DTilesSelection::TileContent &content = pTile->getContent();
-        const Cesium3DTilesSelection::TileRenderContent *pRenderContent =
-            content.getRenderContent();
-        if ( pRenderContent )
+    // Only tiles that were shown or hidden since the last frame are touched. Tiles fading out
+    // are no longer rendered, so they are among the hidden ones.
+    for ( CesiumGltfNode *pCesiumGltfNode : this->shown_nodes )
+    {
+        if ( !shownNodes.count( pCesiumGltfNode ) )
+        {
+            pCesiumGltfNode->set_visible( false );
+        }
+    }
+    for ( CesiumGltfNode *pCesiumGltfNode : shownNodes )
+    {
+        if ( !this->shown_nodes.count( pCesiumGltfNode ) )
         {
-            CesiumGltfNode *pCesiumGltfNode =
-                static_cast<CesiumGltfNode *>( pRenderContent->getRenderResources() );
-            if ( pCesiumGltfNode )
+            pCesiumGltfNode->set_visible( true );
+        }
+    }
+    this->shown_nodes = std::move( shownNodes );
+}
+
+void Cesium3DTileset::update_collision( const ViewUpdateResult &updateResult )
+{
+    // Colliders are only kept for rendered tiles within physics_radius of the camera or of a
+    // physics anchor, so physics cost follows the area around them rather than every tile.
+    const bool collide =
+        this->create_physics_meshes && !godot::Engine::get_singleton()->is_editor_hint();
+    std::vector<Vector3> anchors;
+    if ( collide && this->physics_radius > 0.0f )
+    {
+        godot::Viewport *viewport = this->get_viewport();
+        godot::Camera3D *camera = viewport ? viewport->get_camera_3d() : nullptr;
+        if ( camera )
+        {
+            anchors.push_back( camera->get_global_position() );
+        }
+        for ( auto it = this->physics_anchors.begin(); it != this->physics_anchors.end(); )
+        {
+            Node3D *anchor = Object::cast_to<Node3D>( ObjectDB::get_instance( *it ) );
+            if ( !anchor )
             {
-                pCesiumGltfNode->set_visible( false );
+                it = this->physics_anchors.erase( it );
+                continue;
             }
+            if ( anchor->is_inside_tree() )
+            {
+                anchors.push_back( anchor->get_global_position() );
+            }
+            ++it;
         }
     }
 
+    // The pass walks every rendered tile, so it only runs when its outcome can change: the
+    // rendered tiles, the anchors, the tileset transform or the collision settings moved.
+    const Transform3D tilesetTransform = this->get_global_transform();
+    if ( !this->collision_dirty && anchors == this->last_collision_anchors &&
+         tilesetTransform == this->last_collision_transform )
+    {
+        return;
+    }
+    Ref<World3D> world = this->get_world_3d();
+    if ( world.is_null() )
+    {
+        return;
+    }
+    this->collision_dirty = false;
+    this->last_collision_anchors = anchors;
+    this->last_collision_transform = tilesetTransform;
+
+    const RID space = world->get_space();
+    const real_t radiusSquared = this->physics_radius * this->physics_radius;
+
+    std::unordered_set<CesiumGltfNode *> collisionNodes;
     for ( auto pTile : updateResult.tilesToRenderThisFrame )
     {
-        if ( pTile->getState() != TileLoadState::Done )
+        if ( !collide || pTile->getState() != TileLoadState::Done )
+        {
+            continue;
+        }
+        const TileRenderContent *pRenderContent = pTile->getContent().getRenderContent();
+        CesiumGltfNode *pCesiumGltfNode =
+            pRenderContent ? static_cast<CesiumGltfNode *>( pRenderContent->getRenderResources() )
+                           : nullptr;
+        if ( !pCesiumGltfNode )
         {
             continue;
         }
-        const Cesium3DTilesSelection::TileContent &content = pTile->getContent();
-        const Cesium3DTilesSelection::TileRenderContent *pRenderContent =
-            content.getRenderContent();
-        if ( pRenderContent )
+
+        // A radius of zero keeps colliders for every rendered tile.
+        bool inRange = this->physics_radius <= 0.0f;
+        const Transform3D nodeTransform = tilesetTransform * pCesiumGltfNode->localTransform;
+        const AABB bounds = nodeTransform.xform( pCesiumGltfNode->bounds );
+        for ( const Vector3 &anchor : anchors )
         {
-            CesiumGltfNode *pCesiumGltfNode =
-                static_cast<CesiumGltfNode *>( pRenderContent->getRenderResources() );
-            if ( pCesiumGltfNode )
+            Vector3 closest = anchor.clamp( bounds.position, bounds.position + bounds.size );
+            if ( closest.distance_squared_to( anchor ) <= radiusSquared )
             {
-                pCesiumGltfNode->set_visible( true );
+                inRange = true;
+                break;
             }
         }
+        if ( inRange )
+        {
+            pCesiumGltfNode->update_collision( true, tilesetTransform, space );
+            collisionNodes.insert( pCesiumGltfNode );
+        }
     }
 
-    this->update_load_status();
+    for ( CesiumGltfNode *pCesiumGltfNode : this->collision_nodes )
+    {
+        if ( !collisionNodes.count( pCesiumGltfNode ) )
+        {
+            pCesiumGltfNode->update_collision( false, tilesetTransform, space );
+        }
+    }
+    this->collision_nodes = std::move( collisionNodes );
 }
 
 void Cesium3DTileset::set_url( const String p_url )
@@ -559,6 +814,7 @@ void Cesium3DTileset::set_maximum_screen_space_error( const float p_maximum_scre
     if ( maximum_screen_space_error != p_maximum_screen_space_error )
     {
         this->maximum_screen_space_error = p_maximum_screen_space_error;
+        this->push_tileset_options();
     }
 }
 
@@ -571,6 +827,7 @@ void Cesium3DTileset::set_preload_ancestors( const bool p_preload_ancestors )
     if ( this->preload_ancestors != p_preload_ancestors )
     {
         this->preload_ancestors = p_preload_ancestors;
+        this->push_tileset_options();
     }
 }
 
@@ -583,6 +840,7 @@ void Cesium3DTileset::set_preload_siblings( const bool p_preload_siblings )
     if ( this->preload_siblings != p_preload_siblings )
     {
         this->preload_siblings = p_preload_siblings;
+        this->push_tileset_options();
     }
 }
 
@@ -595,6 +853,7 @@ void Cesium3DTileset::set_forbid_holes( const bool p_forbid_holes )
     if ( this->forbid_holes != p_forbid_holes )
     {
         this->forbid_holes = p_forbid_holes;
+        this->push_tileset_options();
     }
 }
 
@@ -608,6 +867,7 @@ void Cesium3DTileset::set_maximum_simultaneous_tile_loads(
     if ( this->maximum_simultaneous_tile_loads != p_maximum_simultaneous_tile_loads )
     {
         this->maximum_simultaneous_tile_loads = p_maximum_simultaneous_tile_loads;
+        this->push_tileset_options();
     }
 }
 
@@ -620,6 +880,19 @@ void Cesium3DTileset::set_maximum_cached_mbytes( const unsigned int p_maximum_ca
     if ( this->maximum_cached_mbytes != p_maximum_cached_mbytes )
     {
         this->maximum_cached_mbytes = p_maximum_cached_mbytes;
+        this->push_tileset_options();
+    }
+}
+
+void Cesium3DTileset::set_shared_budget( const unsigned int p_tile_loads,
+                                         const unsigned int p_cached_mbytes )
+{
+    // Set by CesiumTilesetManager every frame, so options are only pushed when the share moves.
+    if ( this->shared_tile_loads != p_tile_loads || this->shared_cached_mbytes != p_cached_mbytes )
+    {
+        this->shared_tile_loads = p_tile_loads;
+        this->shared_cached_mbytes = p_cached_mbytes;
+        this->push_tileset_options();
     }
 }
 
@@ -632,6 +905,7 @@ void Cesium3DTileset::set_loading_descendant_limit( const unsigned int p_loading
     if ( this->loading_descendant_limit != p_loading_descendant_limit )
     {
         this->loading_descendant_limit = p_loading_descendant_limit;
+        this->push_tileset_options();
     }
 }
 
@@ -644,6 +918,7 @@ void Cesium3DTileset::set_enable_frustum_culling( const bool p_enable_frustum_cu
     if ( this->enable_frustum_culling != p_enable_frustum_culling )
     {
         this->enable_frustum_culling = p_enable_frustum_culling;
+        this->push_tileset_options();
     }
 }
 
@@ -656,6 +931,7 @@ void Cesium3DTileset::set_enable_fog_culling( const bool p_enable_fog_culling )
     if ( this->enable_fog_culling != p_enable_fog_culling )
     {
         this->enable_fog_culling = p_enable_fog_culling;
+        this->push_tileset_options();
     }
 }
 
@@ -669,6 +945,7 @@ void Cesium3DTileset::set_enforce_culled_screen_space_error(
     if ( this->enforce_culled_screen_space_error != p_enforce_culled_screen_space_error )
     {
         this->enforce_culled_screen_space_error = p_enforce_culled_screen_space_error;
+        this->push_tileset_options();
     }
 }
 
@@ -681,6 +958,7 @@ void Cesium3DTileset::set_culled_screen_space_error( const float p_culled_screen
     if ( this->culled_screen_space_error != p_culled_screen_space_error )
     {
         this->culled_screen_space_error = p_culled_screen_space_error;
+        this->push_tileset_options();
     }
 }
 
@@ -704,8 +982,11 @@ void Cesium3DTileset::set_create_physics_meshes( const bool p_create_physics_mes
 {
     if ( this->create_physics_meshes != p_create_physics_meshes )
     {
+        // Colliders are added and removed by the next collision selection pass. Tiles loaded
+        // while this was off get their collision shape built from their mesh once they are
+        // within range.
         this->create_physics_meshes = p_create_physics_meshes;
-        this->destroy_tileset();
+        this->collision_dirty = true;
     }
 }
 
@@ -722,6 +1003,78 @@ void Cesium3DTileset::set_generate_smooth_normals( const bool p_generate_smooth_
     }
 }
 
+bool Cesium3DTileset::get_use_rendering_server_instances() const
+{
+    return this->use_rendering_server_instances;
+}
+void Cesium3DTileset::set_use_rendering_server_instances(
+    const bool p_use_rendering_server_instances )
+{
+    if ( this->use_rendering_server_instances != p_use_rendering_server_instances )
+    {
+        this->use_rendering_server_instances = p_use_rendering_server_instances;
+        this->destroy_tileset();
+    }
+}
+
+float Cesium3DTileset::get_main_thread_time_budget() const
+{
+    return this->main_thread_time_budget;
+}
+void Cesium3DTileset::set_main_thread_time_budget( const float p_main_thread_time_budget )
+{
+    float budget = std::max( p_main_thread_time_budget, 0.0f );
+    if ( this->main_thread_time_budget != budget )
+    {
+        this->main_thread_time_budget = budget;
+        this->push_tileset_options();
+    }
+}
+
+float Cesium3DTileset::get_physics_radius() const
+{
+    return this->physics_radius;
+}
+void Cesium3DTileset::set_physics_radius( const float p_physics_radius )
+{
+    this->physics_radius = std::max( p_physics_radius, 0.0f );
+    this->collision_dirty = true;
+}
+
+void Cesium3DTileset::add_physics_anchor( Node3D *p_anchor )
+{
+    if ( !p_anchor )
+    {
+        return;
+    }
+    uint64_t id = p_anchor->get_instance_id();
+    if ( std::find( this->physics_anchors.begin(), this->physics_anchors.end(), id ) ==
+         this->physics_anchors.end() )
+    {
+        this->physics_anchors.push_back( id );
+        this->collision_dirty = true;
+    }
+}
+
+void Cesium3DTileset::remove_physics_anchor( Node3D *p_anchor )
+{
+    if ( !p_anchor )
+    {
+        return;
+    }
+    std::erase( this->physics_anchors, p_anchor->get_instance_id() );
+    this->collision_dirty = true;
+}
+
+void Cesium3DTileset::forget_tile_node( CesiumGltfNode *p_node )
+{
+    this->shown_nodes.erase( p_node );
+    this->collision_nodes.erase( p_node );
+    this->collision_dirty = true;
+    // The freed tile may come back with new render resources while still in the list.
+    this->rendered_tiles.clear();
+}
+
 void Cesium3DTileset::set_log_selection_stats( const bool p_log_selection_stats )
 {
     this->log_selection_stats = p_log_selection_stats;
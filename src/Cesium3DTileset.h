@@ -13,10 +13,15 @@
 #include <Cesium3DTilesSelection/ViewUpdateResult.h>
 #include <CesiumGeospatial/LocalHorizontalCoordinateSystem.h>
 
+#include <unordered_set>
+#include <vector>
+
 using namespace godot;
 
 namespace CesiumForGodot
 {
+    struct CesiumGltfNode;
+
     /**
      * @class Cesium3DTileset
      * @brief 3D Tileset loader and renderer for Cesium tilesets.
@@ -31,6 +36,21 @@ namespace CesiumForGodot
         std::unique_ptr<Cesium3DTilesSelection::Tileset> p_tileset;
         Cesium3DTilesSelection::ViewUpdateResult last_update_result;
 
+        /* The result of the last selection traversal, owned by p_tileset. */
+        const Cesium3DTilesSelection::ViewUpdateResult *p_view_update_result = nullptr;
+
+        /* The number of loaded tiles right after the last selection traversal. */
+        int32_t traversal_tiles_loaded = 0;
+
+        /* Set when a setter pushed new options to p_tileset since the last update. */
+        bool options_changed = false;
+
+        /* What the last selection traversal was run for. */
+        std::vector<Cesium3DTilesSelection::ViewState> last_view_states;
+        Transform3D last_global_transform;
+        const CesiumGeoreference *last_georeference = nullptr;
+        uint64_t last_georeference_version = 0;
+
         String url;
         float maximum_screen_space_error;
         bool preload_ancestors;
@@ -46,11 +66,29 @@ namespace CesiumForGodot
         bool suspend_update;
         bool create_physics_meshes;
         bool generate_smooth_normals;
+        bool use_rendering_server_instances;
+        float main_thread_time_budget;
+        float physics_radius;
+        std::vector<uint64_t> physics_anchors;
+
+        /* This tileset's share of the scene-wide budgets, 0 when there is none. */
+        unsigned int shared_tile_loads = 0;
+        unsigned int shared_cached_mbytes = 0;
+
+        /* The tiles rendered last frame, and the tile nodes made visible for them. */
+        decltype( Cesium3DTilesSelection::ViewUpdateResult::tilesToRenderThisFrame ) rendered_tiles;
+        std::unordered_set<CesiumGltfNode *> shown_nodes;
+
+        /* The tile nodes the last collision selection pass wanted colliders for, and what it
+           was run for. collision_dirty forces the next pass. */
+        std::unordered_set<CesiumGltfNode *> collision_nodes;
+        std::vector<Vector3> last_collision_anchors;
+        Transform3D last_collision_transform;
+        bool collision_dirty = true;
         
 
         /* Whether to log details about the tile selection process. */
         bool log_selection_stats;
-        int32_t last_opaque_material_hash;
         float load_progress;
         bool active_loading;
 
@@ -60,7 +98,14 @@ namespace CesiumForGodot
             const Cesium3DTilesSelection::ViewUpdateResult &currentResult );
         float compute_load_progress();
         void update_load_status();
-        void update_tileset_options_from_properties();
+        void write_tileset_options( Cesium3DTilesSelection::TilesetOptions &options ) const;
+        void push_tileset_options();
+        bool update_view_inputs( const std::vector<Cesium3DTilesSelection::ViewState> &viewStates );
+        bool has_pending_tile_work(
+            const Cesium3DTilesSelection::ViewUpdateResult &updateResult ) const;
+        void update_tile_server_objects();
+        void update_visibility( const Cesium3DTilesSelection::ViewUpdateResult &updateResult );
+        void update_collision( const Cesium3DTilesSelection::ViewUpdateResult &updateResult );
 
     protected:
         static void _bind_methods();
@@ -110,6 +155,17 @@ namespace CesiumForGodot
         void set_create_physics_meshes( const bool p_create_physics_meshes );
         bool get_generate_smooth_normals() const;
         void set_generate_smooth_normals( const bool p_generate_smooth_normals );
+        bool get_use_rendering_server_instances() const;
+        void set_use_rendering_server_instances( const bool p_use_rendering_server_instances );
+        float get_main_thread_time_budget() const;
+        void set_main_thread_time_budget( const float p_main_thread_time_budget );
+        float get_physics_radius() const;
+        void set_physics_radius( const float p_physics_radius );
+        void add_physics_anchor( Node3D *p_anchor );
+        void remove_physics_anchor( Node3D *p_anchor );
+        void forget_tile_node( CesiumGltfNode *p_node );
+        void set_shared_budget( const unsigned int p_tile_loads,
+                                const unsigned int p_cached_mbytes );
         void set_log_selection_stats( const bool p_log_selection_stats );
         bool get_log_selection_stats() const;
         bool tiles_destroyed;
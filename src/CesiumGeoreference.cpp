@@ -33,7 +33,7 @@ void CesiumGeoreference::_bind_methods()
 
 CesiumGeoreference::CesiumGeoreference() :
     origin_authority_name( "" ), scale( 1.0f ), localToEcef( glm::dmat4( 1.0f ) ),
-    ecefToLocal( glm::dmat4( 1.0f ) ), coordinate_system()
+    ecefToLocal( glm::dmat4( 1.0f ) ), version( 0 ), coordinate_system()
 {
 }
 
@@ -127,6 +127,8 @@ LocalHorizontalCoordinateSystem CesiumGeoreference::createCoordinateSystem()
                 LocalDirection::East, LocalDirection::Up, LocalDirection::South, 1.0 / scale );
         }
     }
+    // Without an origin, local coordinates are ECEF coordinates.
+    return LocalHorizontalCoordinateSystem( glm::dmat4( 1.0 ) );
 }
 
 const CesiumGeospatial::LocalHorizontalCoordinateSystem &CesiumGeoreference::getCoordinateSystem()
@@ -143,6 +145,12 @@ void CesiumGeoreference::computeLocalToEarthCenteredEarthFixedTransformation()
     this->coordinate_system = this->createCoordinateSystem();
     this->localToEcef = this->coordinate_system->getLocalToEcefTransformation();
     this->ecefToLocal = this->coordinate_system->getEcefToLocalTransformation();
+    ++this->version;
+}
+
+uint64_t CesiumGeoreference::getVersion() const
+{
+    return this->version;
 }
 
 void CesiumGeoreference::updateGeoreference()
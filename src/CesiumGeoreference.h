@@ -23,6 +23,7 @@ namespace CesiumForGodot
         std::optional<CesiumGeospatial::LocalHorizontalCoordinateSystem> coordinate_system;
         glm::dmat4 localToEcef;
         glm::dmat4 ecefToLocal;
+        uint64_t version;
 
     protected:
         static void _bind_methods();
@@ -39,8 +40,17 @@ namespace CesiumForGodot
 
         CesiumGeospatial::LocalHorizontalCoordinateSystem createCoordinateSystem();
 
+        /**
+         * The coordinate system is cached and only rebuilt when the origin or scale changes,
+         * so the returned reference stays valid until then.
+         */
         const CesiumGeospatial::LocalHorizontalCoordinateSystem &getCoordinateSystem();
 
+        /**
+         * Incremented every time the coordinate system is rebuilt.
+         */
+        uint64_t getVersion() const;
+
         void computeLocalToEarthCenteredEarthFixedTransformation();
 
         void updateGeoreference();
@@ -0,0 +1,90 @@
+#include "CesiumSettings.h"
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+namespace CesiumForGodot
+{
+    namespace
+    {
+        void defineSetting( const String &name, const Variant &defaultValue,
+                            PropertyHint hint = PROPERTY_HINT_NONE, const String &hintString = "" )
+        {
+            ProjectSettings *settings = ProjectSettings::get_singleton();
+            if ( !settings->has_setting( name ) )
+            {
+                settings->set_setting( name, defaultValue );
+            }
+            settings->set_initial_value( name, defaultValue );
+
+            Dictionary info;
+            info["name"] = name;
+            info["type"] = defaultValue.get_type();
+            info["hint"] = hint;
+            info["hint_string"] = hintString;
+            settings->add_property_info( info );
+        }
+    } // namespace
+
+    namespace Settings
+    {
+        void registerProjectSettings()
+        {
+            defineSetting( workerThreadCount, 0, PROPERTY_HINT_RANGE, "0,64,1" );
+            defineSetting( maximumConnectionsPerHost, 20, PROPERTY_HINT_RANGE, "1,128,1" );
+            defineSetting( networkTickTimeBudget, 2.0, PROPERTY_HINT_RANGE, "0.1,50,0.1" );
+            defineSetting( requestTimeout, 30.0, PROPERTY_HINT_RANGE, "1,600,1" );
+            defineSetting( totalTileLoads, 0, PROPERTY_HINT_RANGE, "0,256,1,or_greater" );
+            defineSetting( totalCachedMbytes, 0, PROPERTY_HINT_RANGE, "0,65536,1,or_greater" );
+        }
+
+        uint32_t getWorkerThreadCount()
+        {
+            int64_t count = ProjectSettings::get_singleton()->get_setting( workerThreadCount, 0 );
+            if ( count > 0 )
+            {
+                return static_cast<uint32_t>( count );
+            }
+            int32_t processors = OS::get_singleton()->get_processor_count();
+            return static_cast<uint32_t>( std::max( processors - 1, 1 ) );
+        }
+
+        int32_t getMaximumConnectionsPerHost()
+        {
+            int64_t connections =
+                ProjectSettings::get_singleton()->get_setting( maximumConnectionsPerHost, 20 );
+            return static_cast<int32_t>( std::clamp<int64_t>( connections, 1, INT32_MAX ) );
+        }
+
+        double getNetworkTickTimeBudget()
+        {
+            double milliseconds =
+                ProjectSettings::get_singleton()->get_setting( networkTickTimeBudget, 2.0 );
+            return std::max( milliseconds, 0.1 );
+        }
+
+        double getRequestTimeout()
+        {
+            double seconds = ProjectSettings::get_singleton()->get_setting( requestTimeout, 30.0 );
+            return std::max( seconds, 1.0 );
+        }
+
+        uint32_t getTotalTileLoads()
+        {
+            int64_t loads = ProjectSettings::get_singleton()->get_setting( totalTileLoads, 0 );
+            return static_cast<uint32_t>( std::max<int64_t>( loads, 0 ) );
+        }
+
+        uint32_t getTotalCachedMbytes()
+        {
+            int64_t mbytes = ProjectSettings::get_singleton()->get_setting( totalCachedMbytes, 0 );
+            return static_cast<uint32_t>( std::max<int64_t>( mbytes, 0 ) );
+        }
+    } // namespace Settings
+
+} // namespace CesiumForGodot
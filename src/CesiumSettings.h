@@ -0,0 +1,55 @@
+#ifndef CESIUM_SETTINGS_H
+#define CESIUM_SETTINGS_H
+
+#include <cstdint>
+
+namespace CesiumForGodot
+{
+    /**
+     * Project settings used by the extension. They are registered with default values when the
+     * extension is initialized so they show up under "Cesium" in the Project Settings dialog.
+     */
+    namespace Settings
+    {
+        const char workerThreadCount[] = "cesium/threading/worker_thread_count";
+        const char maximumConnectionsPerHost[] = "cesium/network/maximum_connections_per_host";
+        const char networkTickTimeBudget[] = "cesium/network/tick_time_budget_ms";
+        const char requestTimeout[] = "cesium/network/request_timeout_seconds";
+        const char totalTileLoads[] = "cesium/tilesets/maximum_simultaneous_tile_loads";
+        const char totalCachedMbytes[] = "cesium/tilesets/maximum_cached_mbytes";
+
+        void registerProjectSettings();
+
+        /**
+         * Number of threads in the worker pool that runs cesium-native tasks. A setting of 0
+         * means one thread per logical core, minus one for the main thread.
+         */
+        uint32_t getWorkerThreadCount();
+
+        /**
+         * Number of keep-alive HTTP connections the asset accessor opens to a single host. It
+         * is shared by all tilesets.
+         */
+        int32_t getMaximumConnectionsPerHost();
+
+        /**
+         * Main-thread time, in milliseconds, spent each frame advancing HTTP requests.
+         */
+        double getNetworkTickTimeBudget();
+
+        /**
+         * Seconds an HTTP request may go without progress before it fails.
+         */
+        double getRequestTimeout();
+
+        /**
+         * Budgets shared by all tilesets in the scene, split evenly between them. Each tileset
+         * still keeps to its own limits when they are lower. A setting of 0 means no shared limit.
+         */
+        uint32_t getTotalTileLoads();
+        uint32_t getTotalCachedMbytes();
+    } // namespace Settings
+
+} // namespace CesiumForGodot
+
+#endif
@@ -0,0 +1,108 @@
+#include "CesiumTilesetManager.h"
+#include "Cesium3DTileset.h"
+#include "CesiumSettings.h"
+#include "GodotAssetAccessor.h"
+#include "GodotTilesetExternals.h"
+
+#include <godot_cpp/classes/engine.hpp>
+
+#include <algorithm>
+
+using namespace Cesium3DTilesSelection;
+
+namespace CesiumForGodot
+{
+    CesiumTilesetManager &CesiumTilesetManager::get()
+    {
+        static CesiumTilesetManager manager;
+        return manager;
+    }
+
+    void CesiumTilesetManager::registerTileset( Cesium3DTileset *pTileset )
+    {
+        if ( std::find( this->_tilesets.begin(), this->_tilesets.end(), pTileset ) ==
+             this->_tilesets.end() )
+        {
+            this->_tilesets.push_back( pTileset );
+        }
+    }
+
+    void CesiumTilesetManager::unregisterTileset( Cesium3DTileset *pTileset )
+    {
+        this->_tilesets.erase(
+            std::remove( this->_tilesets.begin(), this->_tilesets.end(), pTileset ),
+            this->_tilesets.end() );
+    }
+
+    void CesiumTilesetManager::update( double delta )
+    {
+        const uint64_t frame = godot::Engine::get_singleton()->get_process_frames();
+        if ( frame == this->_lastUpdateFrame )
+        {
+            return;
+        }
+        this->_lastUpdateFrame = frame;
+
+        // cesium-native only ticks the asset accessor while waiting for the tileset to go idle,
+        // so HTTP requests are advanced from here, once per frame.
+        getGodotAssetAccessor()->tick();
+
+        // Suspended, hidden and paused tilesets are left as they are, and get no share of the
+        // budgets.
+        std::vector<Cesium3DTileset *> tilesets;
+        for ( Cesium3DTileset *pTileset : this->_tilesets )
+        {
+            if ( pTileset->is_processing() && pTileset->can_process() &&
+                 pTileset->is_visible_in_tree() && !pTileset->get_suspend_update() )
+            {
+                tilesets.push_back( pTileset );
+            }
+        }
+        this->updateBudgets( tilesets );
+
+        for ( Cesium3DTileset *pTileset : tilesets )
+        {
+            // A tileset may leave the tree, and so unregister, while another one is updated.
+            if ( std::find( this->_tilesets.begin(), this->_tilesets.end(), pTileset ) !=
+                 this->_tilesets.end() )
+            {
+                pTileset->update( delta );
+            }
+        }
+    }
+
+    std::vector<ViewState> CesiumTilesetManager::getViewStates( const Cesium3DTileset &tileset )
+    {
+        const uint64_t frame = godot::Engine::get_singleton()->get_process_frames();
+        if ( frame != this->_cameraViewsFrame )
+        {
+            this->_cameraViews.clear();
+            this->_cameraViewsFrame = frame;
+        }
+
+        const godot::Viewport *viewport = tileset.get_viewport();
+        auto it = this->_cameraViews.find( viewport );
+        if ( it == this->_cameraViews.end() )
+        {
+            it = this->_cameraViews
+                     .emplace( viewport, CameraManager::getAllCameraViews( viewport ) )
+                     .first;
+        }
+        return CameraManager::toViewStates( tileset, it->second );
+    }
+
+    void CesiumTilesetManager::updateBudgets( const std::vector<Cesium3DTileset *> &tilesets )
+    {
+        // An even split; each tileset's own limits still apply on top of its share.
+        const uint32_t count = static_cast<uint32_t>( std::max<size_t>( tilesets.size(), 1 ) );
+        const uint32_t totalLoads = Settings::getTotalTileLoads();
+        const uint32_t totalMbytes = Settings::getTotalCachedMbytes();
+        const uint32_t loads = totalLoads > 0 ? std::max( totalLoads / count, 1u ) : 0;
+        const uint32_t mbytes = totalMbytes > 0 ? std::max( totalMbytes / count, 1u ) : 0;
+        for ( Cesium3DTileset *pTileset : tilesets )
+        {
+            pTileset->set_shared_budget( loads, mbytes );
+        }
+    }
+
+} // namespace CesiumForGodot
@@ -0,0 +1,61 @@
+#ifndef CESIUM_TILESET_MANAGER_H
+#define CESIUM_TILESET_MANAGER_H
+
+#include <Cesium3DTilesSelection/ViewState.h>
+
+#include <godot_cpp/classes/viewport.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "CameraManager.h"
+
+namespace CesiumForGodot
+{
+    class Cesium3DTileset;
+
+    /**
+     * Updates all tilesets in the scene once per frame. Cameras are gathered once per viewport
+     * and frame and then converted for each tileset, and the shared budgets from the project
+     * settings are split between the tilesets.
+     *
+     * Tilesets are updated one after the other on the main thread: the selection traversal
+     * finishes tile loads through IPrepareRendererResources, which creates scene nodes.
+     */
+    class CesiumTilesetManager
+    {
+    public:
+        static CesiumTilesetManager &get();
+
+        void registerTileset( Cesium3DTileset *pTileset );
+        void unregisterTileset( Cesium3DTileset *pTileset );
+
+        /**
+         * Called by every tileset when it processes. The first call of a frame updates all
+         * tilesets that can process and are visible and not suspended; the others return.
+         */
+        void update( double delta );
+
+        /**
+         * The view states of the cameras looking at the tileset this frame.
+         */
+        std::vector<Cesium3DTilesSelection::ViewState> getViewStates(
+            const Cesium3DTileset &tileset );
+
+    private:
+        CesiumTilesetManager() = default;
+
+        void updateBudgets( const std::vector<Cesium3DTileset *> &tilesets );
+
+        std::vector<Cesium3DTileset *> _tilesets;
+        uint64_t _lastUpdateFrame = UINT64_MAX;
+
+        // The cameras of each viewport, gathered on first use in the frame they were for.
+        std::unordered_map<const godot::Viewport *, std::vector<CameraView>> _cameraViews;
+        uint64_t _cameraViewsFrame = UINT64_MAX;
+    };
+
+} // namespace CesiumForGodot
+
+#endif
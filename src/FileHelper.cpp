@@ -1,7 +1,186 @@
 #include "FileHelper.h"
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace FileHelper
 {
+    namespace
+    {
+        const size_t maximumOpenMappings = 256;
+
+        // Identifies a version of a file, so a cached mapping of a file that has since been
+        // rewritten is not handed out.
+        struct FileStamp
+        {
+            uint64_t size = 0;
+            int64_t modifiedTime = 0;
+
+            bool operator==( const FileStamp &other ) const
+            {
+                return size == other.size && modifiedTime == other.modifiedTime;
+            }
+        };
+
+#ifdef _WIN32
+        bool statFile( const std::string &filename, FileStamp &stamp )
+        {
+            WIN32_FILE_ATTRIBUTE_DATA attributes;
+            if ( !GetFileAttributesExA( filename.c_str(), GetFileExInfoStandard, &attributes ) ||
+                 ( attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) )
+            {
+                return false;
+            }
+            stamp.size = ( static_cast<uint64_t>( attributes.nFileSizeHigh ) << 32 ) |
+                         attributes.nFileSizeLow;
+            stamp.modifiedTime =
+                ( static_cast<int64_t>( attributes.ftLastWriteTime.dwHighDateTime ) << 32 ) |
+                attributes.ftLastWriteTime.dwLowDateTime;
+            return true;
+        }
+
+        const void *mapWholeFile( const std::string &filename, uint64_t size )
+        {
+            HANDLE file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+            if ( file == INVALID_HANDLE_VALUE )
+            {
+                return nullptr;
+            }
+            HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            CloseHandle( file );
+            if ( !mapping )
+            {
+                return nullptr;
+            }
+            // The view keeps the file mapping alive after the handles are closed.
+            const void *view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, size );
+            CloseHandle( mapping );
+            return view;
+        }
+
+        void unmapFile( const void *data, [[maybe_unused]] size_t size )
+        {
+            UnmapViewOfFile( data );
+        }
+#else
+        bool statFile( const std::string &filename, FileStamp &stamp )
+        {
+            struct stat st;
+            if ( ::stat( filename.c_str(), &st ) != 0 || !S_ISREG( st.st_mode ) )
+            {
+                return false;
+            }
+            stamp.size = static_cast<uint64_t>( st.st_size );
+            // Nanoseconds, so a rewrite within the same second still changes the stamp.
+#ifdef __APPLE__
+            const struct timespec &modified = st.st_mtimespec;
+#else
+            const struct timespec &modified = st.st_mtim;
+#endif
+            stamp.modifiedTime = static_cast<int64_t>( modified.tv_sec ) * 1000000000 +
+                                 static_cast<int64_t>( modified.tv_nsec );
+            return true;
+        }
+
+        const void *mapWholeFile( const std::string &filename, uint64_t size )
+        {
+            int fd = ::open( filename.c_str(), O_RDONLY | O_CLOEXEC );
+            if ( fd < 0 )
+            {
+                return nullptr;
+            }
+            void *data = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            ::close( fd );
+            if ( data == MAP_FAILED )
+            {
+                return nullptr;
+            }
+            // Tiles are parsed front to back right after loading.
+            ::madvise( data, size, MADV_WILLNEED );
+            return data;
+        }
+
+        void unmapFile( const void *data, size_t size )
+        {
+            ::munmap( const_cast<void *>( data ), size );
+        }
+#endif
+
+        class MappedFileCache
+        {
+        public:
+            std::shared_ptr<const MappedFile> find( const std::string &filename,
+                                                    const FileStamp &stamp )
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                auto it = _index.find( filename );
+                if ( it == _index.end() )
+                {
+                    return nullptr;
+                }
+                if ( !( it->second->stamp == stamp ) )
+                {
+                    _entries.erase( it->second );
+                    _index.erase( it );
+                    return nullptr;
+                }
+                _entries.splice( _entries.begin(), _entries, it->second );
+                return it->second->pFile;
+            }
+
+            void insert( const std::string &filename, const FileStamp &stamp,
+                         std::shared_ptr<const MappedFile> pFile )
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                auto it = _index.find( filename );
+                if ( it != _index.end() )
+                {
+                    _entries.erase( it->second );
+                    _index.erase( it );
+                }
+                _entries.push_front( Entry{ filename, stamp, std::move( pFile ) } );
+                _index[filename] = _entries.begin();
+
+                // Evicted mappings stay valid for as long as a response still references them.
+                while ( _entries.size() > maximumOpenMappings )
+                {
+                    _index.erase( _entries.back().filename );
+                    _entries.pop_back();
+                }
+            }
+
+        private:
+            struct Entry
+            {
+                std::string filename;
+                FileStamp stamp;
+                std::shared_ptr<const MappedFile> pFile;
+            };
+
+            std::mutex _mutex;
+            // Most recently used first.
+            std::list<Entry> _entries;
+            std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+        };
+    } // namespace
+
     bool loadFile( std::vector<std::byte> &data, const std::string &filename )
     {
         std::ifstream file( filename, std::ios::binary | std::ios::ate );
@@ -23,6 +202,44 @@ namespace FileHelper
         return true;
     }
 
+    MappedFile::~MappedFile()
+    {
+        if ( _data )
+        {
+            unmapFile( _data, _size );
+        }
+    }
+
+    std::shared_ptr<const MappedFile> mapFile( const std::string &filename )
+    {
+        static MappedFileCache cache;
+
+        FileStamp stamp;
+        if ( !statFile( filename, stamp ) )
+        {
+            return nullptr;
+        }
+        std::shared_ptr<const MappedFile> pCached = cache.find( filename, stamp );
+        if ( pCached )
+        {
+            return pCached;
+        }
+
+        std::shared_ptr<MappedFile> pFile( new MappedFile() );
+        if ( stamp.size > 0 )
+        {
+            const void *data = mapWholeFile( filename, stamp.size );
+            if ( !data )
+            {
+                return nullptr;
+            }
+            pFile->_data = static_cast<const std::byte *>( data );
+            pFile->_size = static_cast<size_t>( stamp.size );
+        }
+        cache.insert( filename, stamp, pFile );
+        return pFile;
+    }
+
     bool isWindowsFilePath( const std::string &url )
     {
         if ( url.size() < 3 )
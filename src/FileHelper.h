@@ -2,7 +2,11 @@
 #define FILEHELPER_H
 
 #include <cstddef> // for std::byte
+#include <cstdint>
 #include <fstream>
+#include <memory>
+#include <span>
+#include <string>
 #include <system_error> // for std::error_code and std::make_error_code
 #include <vector>
 
@@ -11,6 +15,39 @@ namespace FileHelper
 
     bool loadFile( std::vector<std::byte> &data, const std::string &filename );
 
+    /**
+     * A read-only memory mapping of a whole file. The mapping is released when the last
+     * reference goes away.
+     */
+    class MappedFile
+    {
+    public:
+        ~MappedFile();
+
+        MappedFile( const MappedFile & ) = delete;
+        MappedFile &operator=( const MappedFile & ) = delete;
+
+        std::span<const std::byte> data() const
+        {
+            return { _data, _size };
+        }
+
+    private:
+        friend std::shared_ptr<const MappedFile> mapFile( const std::string &filename );
+
+        MappedFile() = default;
+
+        const std::byte *_data = nullptr;
+        size_t _size = 0;
+    };
+
+    /**
+     * Maps a file into memory, returning nullptr if it can't be opened. Recently used mappings
+     * are kept open in a small LRU, so re-reading a tile only costs a stat() and page faults
+     * for pages that were evicted.
+     */
+    std::shared_ptr<const MappedFile> mapFile( const std::string &filename );
+
     bool isWindowsFilePath( const std::string &url );
 
     bool isUnixFilePath( const std::string &url );
@@ -20,4 +57,4 @@ namespace FileHelper
 
 } // namespace FileHelper
 
-#endif // FILEHELPER_H
\ No newline at end of file
+#endif // FILEHELPER_H
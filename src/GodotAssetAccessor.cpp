@@ -1,19 +1,26 @@
 #include "GodotAssetAccessor.h"
 #include "Cesium.h"
 #include "FileHelper.h"
+#include "GodotTilesetExternals.h"
+#include "IoUringFileReader.h"
 
 #include <CesiumAsync/IAssetResponse.h>
 
 #include <godot_cpp/classes/http_request.hpp>
+#include <godot_cpp/classes/tls_options.hpp>
 #include <godot_cpp/core/version.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <uriparser/Uri.h>
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <cstddef>
-#include <future>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
-#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,48 +35,113 @@ using namespace godot;
 
 namespace
 {
-    std::tuple<std::string, std::string, std::string> extract_url_parts( const std::string &url )
+    struct UrlParts
     {
+        bool useTls = false;
         std::string host;
-        std::string port;
+        int32_t port = 80;
         std::string path;
+    };
 
-        size_t protocol_end = url.find( "//" ) + 2;
-        size_t path_start = url.find( '/', protocol_end );
+    std::optional<UrlParts> extract_url_parts( const std::string &url )
+    {
+        UrlParts parts;
 
-        std::string host_port = url.substr( protocol_end, path_start - protocol_end );
+        size_t scheme_end = url.find( "://" );
+        if ( scheme_end == std::string::npos )
+        {
+            return std::nullopt;
+        }
+        std::string scheme = url.substr( 0, scheme_end );
+        std::transform( scheme.begin(), scheme.end(), scheme.begin(),
+                        []( unsigned char c ) { return static_cast<char>( std::tolower( c ) ); } );
+        if ( scheme == "https" )
+        {
+            parts.useTls = true;
+            parts.port = 443;
+        }
+        else if ( scheme != "http" )
+        {
+            return std::nullopt;
+        }
+
+        size_t host_start = scheme_end + 3;
+        size_t path_start = url.find_first_of( "/?#", host_start );
+        std::string host_port = url.substr( host_start, path_start - host_start );
 
-        size_t port_start = host_port.find( ':' );
-        if ( port_start != std::string::npos )
+        size_t port_start = host_port.rfind( ':' );
+        if ( port_start != std::string::npos &&
+             host_port.find( ']', port_start ) == std::string::npos )
         {
-            host = host_port.substr( 0, port_start );
-            port = host_port.substr( port_start + 1 );
+            const char *first = host_port.data() + port_start + 1;
+            const char *last = host_port.data() + host_port.size();
+            if ( first != last )
+            {
+                auto [ptr, ec] = std::from_chars( first, last, parts.port );
+                if ( ec != std::errc() || ptr != last )
+                {
+                    return std::nullopt;
+                }
+            }
+            parts.host = host_port.substr( 0, port_start );
         }
         else
         {
-            host = host_port;
-            port = "";
+            parts.host = host_port;
+        }
+        if ( parts.host.empty() )
+        {
+            return std::nullopt;
+        }
+        if ( parts.host == "localhost" )
+        {
+            parts.host = "127.0.0.1";
         }
 
         if ( path_start != std::string::npos )
         {
-            path = url.substr( path_start );
+            parts.path = url.substr( path_start, url.find( '#', path_start ) - path_start );
         }
-        if ( host == "localhost" )
+        if ( parts.path.empty() || parts.path[0] != '/' )
         {
-            host = "127.0.0.1";
+            parts.path.insert( 0, "/" );
         }
 
-        return { host, port, path };
+        return parts;
     }
 
+    HTTPClient::Method to_http_method( const std::string &verb )
+    {
+        static const std::pair<const char *, HTTPClient::Method> methods[] = {
+            { "GET", HTTPClient::METHOD_GET },         { "HEAD", HTTPClient::METHOD_HEAD },
+            { "POST", HTTPClient::METHOD_POST },       { "PUT", HTTPClient::METHOD_PUT },
+            { "DELETE", HTTPClient::METHOD_DELETE },   { "OPTIONS", HTTPClient::METHOD_OPTIONS },
+            { "TRACE", HTTPClient::METHOD_TRACE },     { "CONNECT", HTTPClient::METHOD_CONNECT },
+            { "PATCH", HTTPClient::METHOD_PATCH },
+        };
+        for ( const auto &[name, method] : methods )
+        {
+            if ( verb == name )
+            {
+                return method;
+            }
+        }
+        return HTTPClient::METHOD_MAX;
+    }
+
+    /**
+     * HTTP response whose body stays in the PackedByteArray the HTTPClient chunks were read
+     * into; data() is a view over that storage rather than a copy.
+     */
     class GodotAssetResponse : public CesiumAsync::IAssetResponse
     {
     public:
-        GodotAssetResponse( CesiumForGodot::AHttpResponse response ) : _pResponse( response )
+        GodotAssetResponse( CesiumForGodot::AHttpResponse &&response ) :
+            _pResponse( std::move( response ) )
         {
-            this->_statusCode = static_cast<uint16_t>( response.code );
-            godot::Dictionary responseHeaders = response.headers;
+            const CesiumForGodot::AHttpResponse &response_ = this->_pResponse;
+            this->_statusCode = static_cast<uint16_t>( response_.code );
+            godot::Dictionary responseHeaders = response_.headers;
             if ( !responseHeaders.is_empty() )
             {
                 godot::Array keys = responseHeaders.keys();
@@ -92,9 +164,6 @@ namespace
                     }
                 }
             }
-            this->_data.resize( response.data.size() );
-            const uint8_t *data_ptr = reinterpret_cast<const uint8_t *>( response.data.ptr() );
-            std::memcpy( this->_data.data(), data_ptr, response.data.size() );
         }
 
         virtual uint16_t statusCode() const override
@@ -114,14 +183,15 @@ namespace
 
         virtual std::span<const std::byte> data() const override
         {
-            return this->_data;
+            const godot::PackedByteArray &body = this->_pResponse.data;
+            return std::span<const std::byte>( reinterpret_cast<const std::byte *>( body.ptr() ),
+                                               static_cast<size_t>( body.size() ) );
         }
 
     private:
         uint16_t _statusCode = 0;
         std::string _contentType;
         CesiumAsync::HttpHeaders _headers;
-        std::vector<std::byte> _data;
         CesiumForGodot::AHttpResponse _pResponse;
     };
 
@@ -204,7 +274,13 @@ namespace
     public:
         GodotFileAssetRequestResponse( std::string &&url, uint16_t statusCode,
                                        std::vector<std::byte> &&data ) :
-            _url( std::move( url ) ), _statusCode( statusCode ), _data( data )
+            _url( std::move( url ) ), _statusCode( statusCode ), _data( std::move( data ) )
+        {
+        }
+
+        GodotFileAssetRequestResponse( std::string &&url,
+                                       std::shared_ptr<const FileHelper::MappedFile> &&pFile ) :
+            _url( std::move( url ) ), _statusCode( 200 ), _pMappedFile( std::move( pFile ) )
         {
         }
 
@@ -240,6 +316,10 @@ namespace
 
         virtual std::span<const std::byte> data() const override
         {
+            if ( this->_pMappedFile )
+            {
+                return this->_pMappedFile->data();
+            }
             return this->_data;
         }
 
@@ -250,6 +330,8 @@ namespace
         std::string _url;
         uint16_t _statusCode;
         std::vector<std::byte> _data;
+        // Set instead of _data when the file could be memory-mapped.
+        std::shared_ptr<const FileHelper::MappedFile> _pMappedFile;
     };
 
     const std::string GodotFileAssetRequestResponse::getMethod = "GET";
@@ -257,9 +339,6 @@ namespace
 
     class GodotReadFileTask
     {
-    public:
-        static thread_pool pool;
-
     public:
         GodotReadFileTask( const std::string &url, const CesiumAsync::AsyncSystem &asynSystem ) :
             _url( url ),
@@ -274,12 +353,43 @@ namespace
 
         void startBackgroundTask()
         {
-            pool.enqueueWork( [this] { this->doTask(); } );
+            CesiumForGodot::getWorkerPool().enqueueWork( [this] { this->doTask(); } );
         }
 
         void doTask()
         {
             std::string fileName = convertFileUriToFilename( this->_url );
+
+            // io_uring is the primary path when it was compiled in. Reads it can't take, or
+            // hands back because the ring failed, are done the regular way.
+            bool queued = CesiumForGodot::readFileWithIoUring(
+                fileName, [this]( uint16_t statusCode, std::vector<std::byte> &&data ) {
+                    if ( statusCode == 0 )
+                    {
+                        CesiumForGodot::getWorkerPool().enqueueWork(
+                            [this] { this->readFile(); } );
+                        return;
+                    }
+                    _promise.resolve( std::make_shared<GodotFileAssetRequestResponse>(
+                        std::move( this->_url ), statusCode, std::move( data ) ) );
+                } );
+            if ( !queued )
+            {
+                this->readFile();
+            }
+        }
+
+        void readFile()
+        {
+            std::string fileName = convertFileUriToFilename( this->_url );
+            std::shared_ptr<const FileHelper::MappedFile> pFile = FileHelper::mapFile( fileName );
+            if ( pFile )
+            {
+                _promise.resolve( std::make_shared<GodotFileAssetRequestResponse>(
+                    std::move( this->_url ), std::move( pFile ) ) );
+                return;
+            }
+
             std::vector<std::byte> data;
             if ( FileHelper::loadFile( data, fileName ) )
             {
@@ -298,8 +408,6 @@ namespace
         CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>> _promise;
     };
 
-    thread_pool GodotReadFileTask::pool;
-
     CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> getFromFile(
         const CesiumAsync::AsyncSystem &asyncSystem, const std::string &url,
         const std::vector<std::pair<std::string, std::string>> &headers )
@@ -328,7 +436,9 @@ namespace CesiumForGodot
 {
 
     GodotAssetAccessor::GodotAssetAccessor() :
-        _cesiumRequestHeaders(), _userAgent( "Mozilla 5.0/ Cesium Godot Plugin" )
+        _cesiumRequestHeaders(), _userAgent( "Mozilla 5.0/ Cesium Godot Plugin" ),
+        _maximumConnectionsPerHost( 20 ), _tickTimeBudget( std::chrono::milliseconds( 2 ) ),
+        _requestTimeout( std::chrono::seconds( 30 ) ), _nextConnection( 0 )
     {
         std::string project_name = "CesiumForGodotProject";
         std::string engine = ENGINE_VERSION;
@@ -340,8 +450,6 @@ namespace CesiumForGodot
         this->_cesiumRequestHeaders.insert( { "X-Cesium-Client-Project", project_name } );
         this->_cesiumRequestHeaders.insert( { "X-Cesium-Client-Engine", engine } );
         this->_cesiumRequestHeaders.insert( { "X-Cesium-Client-OS", os_version } );
-
-        this->_http_client.instantiate();
     }
 
     CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> GodotAssetAccessor::get(
@@ -356,120 +464,430 @@ namespace CesiumForGodot
             return result;
         }
 
-        CesiumAsync::HttpHeaders cesiumRequestHeaders = this->_cesiumRequestHeaders;
-        godot::String userAgent = this->_userAgent;
-        Ref<HTTPClient> httpClient = this->_http_client;
+        return this->request( asyncSystem, "GET", url, headers );
+    }
 
-        return asyncSystem.createFuture<std::shared_ptr<CesiumAsync::IAssetRequest>>(
-            [&url, &headers, &userAgent, &cesiumRequestHeaders,
-             &httpClient]( const auto &promise ) {
-                auto [host, port, path] = extract_url_parts( url );
-                String _host( host.c_str() );
-                int32_t _port( static_cast<int32_t>( std::stoi( port ) ) );
-                String _path( path.c_str() );
-                HTTPClient::Status status = httpClient->get_status();
+    CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> GodotAssetAccessor::request(
+        const CesiumAsync::AsyncSystem &asyncSystem, const std::string &verb,
+        const std::string &url, const std::vector<THeader> &headers,
+        const std::span<const std::byte> &contentPayload )
+    {
+        std::optional<UrlParts> urlParts = extract_url_parts( url );
+        HTTPClient::Method httpMethod = to_http_method( verb );
+        if ( !urlParts || httpMethod == HTTPClient::METHOD_MAX )
+        {
+            return asyncSystem.createFuture<std::shared_ptr<CesiumAsync::IAssetRequest>>(
+                [&url]( const auto &promise ) {
+                    promise.reject( std::runtime_error( "Unsupported request: " + url ) );
+                } );
+        }
 
-                if ( status == HTTPClient::STATUS_DISCONNECTED ||
-                     status == HTTPClient::STATUS_CONNECTION_ERROR )
-                {
-                    godot::Error err = httpClient->connect_to_host( _host, _port );
-                    if ( err != Error::OK )
-                    {
-                        promise.reject( std::runtime_error( "Connect to host failed." ) );
-                    }
-                    status = httpClient->get_status();
-                    while ( status == HTTPClient::STATUS_CONNECTING ||
-                            status == HTTPClient::STATUS_RESOLVING )
-                    {
-                        httpClient->poll();
-                        // SPDLOG_INFO( "Connecting..." );
-                        status = httpClient->get_status();
-                    }
-                }
+        auto pRequest = std::make_unique<HttpRequest>(
+            asyncSystem.createPromise<std::shared_ptr<CesiumAsync::IAssetRequest>>() );
+        pRequest->method = verb;
+        pRequest->url = url;
+        pRequest->httpMethod = httpMethod;
+        pRequest->host = std::move( urlParts->host );
+        pRequest->port = urlParts->port;
+        pRequest->useTls = urlParts->useTls;
+        pRequest->path = String::utf8( urlParts->path.c_str() );
+
+        pRequest->headers = this->_cesiumRequestHeaders;
+        for ( const auto &header : headers )
+        {
+            pRequest->headers[header.first] = header.second;
+        }
+        for ( const auto &header : pRequest->headers )
+        {
+            std::string hs = header.first + ":" + header.second;
+            pRequest->requestHeaders.push_back( String::utf8( hs.c_str() ) );
+        }
+        pRequest->requestHeaders.push_back( "User-Agent: " + this->_userAgent );
+        pRequest->requestHeaders.push_back( "Accept: */*" );
+
+        if ( !contentPayload.empty() )
+        {
+            pRequest->body.resize( static_cast<int64_t>( contentPayload.size() ) );
+            std::memcpy( pRequest->body.ptrw(), contentPayload.data(), contentPayload.size() );
+        }
+
+        CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> future =
+            pRequest->promise.getFuture();
+        pRequest->queued = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock( this->_pendingMutex );
+            this->_pendingRequests.push_back( std::move( pRequest ) );
+        }
+        return future;
+    }
+
+    void GodotAssetAccessor::tick() noexcept
+    {
+        this->_tickDeadline = std::chrono::steady_clock::now() + this->_tickTimeBudget;
+        this->assignPendingRequests();
+
+        // Resume where the previous tick ran out of time, so connections at the end of the
+        // list are not starved when the budget is tight.
+        const size_t connectionCount = this->_connections.size();
+        for ( size_t i = 0; i < connectionCount; ++i )
+        {
+            const size_t index = ( this->_nextConnection + i ) % connectionCount;
+            HttpConnection &connection = *this->_connections[index];
+            if ( connection.pRequest )
+            {
+                this->pollConnection( connection );
+            }
+            if ( std::chrono::steady_clock::now() > this->_tickDeadline )
+            {
+                this->_nextConnection = index + 1;
+                break;
+            }
+        }
+        this->closeSurplusConnections();
+    }
+
+    void GodotAssetAccessor::setMaximumConnectionsPerHost( int32_t maximumConnections )
+    {
+        this->_maximumConnectionsPerHost = std::max( maximumConnections, 1 );
+    }
+
+    int32_t GodotAssetAccessor::getMaximumConnectionsPerHost() const
+    {
+        return this->_maximumConnectionsPerHost;
+    }
+
+    void GodotAssetAccessor::setTickTimeBudget( double milliseconds )
+    {
+        this->_tickTimeBudget =
+            std::chrono::microseconds( static_cast<int64_t>( milliseconds * 1000.0 ) );
+    }
+
+    double GodotAssetAccessor::getTickTimeBudget() const
+    {
+        return static_cast<double>( this->_tickTimeBudget.count() ) / 1000.0;
+    }
+
+    void GodotAssetAccessor::setRequestTimeout( double seconds )
+    {
+        this->_requestTimeout =
+            std::chrono::milliseconds( static_cast<int64_t>( seconds * 1000.0 ) );
+    }
 
-                PackedStringArray packed_headers;
-                for ( const auto &header : headers )
+    double GodotAssetAccessor::getRequestTimeout() const
+    {
+        return static_cast<double>( this->_requestTimeout.count() ) / 1000.0;
+    }
+
+    void GodotAssetAccessor::assignPendingRequests()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<HttpRequest>> timedOut;
+        {
+            std::lock_guard<std::mutex> lock( this->_pendingMutex );
+            for ( auto it = this->_pendingRequests.begin(); it != this->_pendingRequests.end(); )
+            {
+                // Requests waiting for a connection to a slow host time out as well.
+                if ( now - ( *it )->queued > this->_requestTimeout )
                 {
-                    std::string hs = header.first + ":" + header.second;
-                    // if ( header.first == "If-None-Match" )
-                    // {
-                    //     continue;
-                    // }
-                    packed_headers.push_back( godot::String( hs.c_str() ) );
+                    timedOut.push_back( std::move( *it ) );
+                    it = this->_pendingRequests.erase( it );
+                    continue;
                 }
-                for ( const auto &header : cesiumRequestHeaders )
+                HttpConnection *pConnection = this->acquireConnection( **it );
+                if ( !pConnection )
                 {
-                    std::string hs = header.first + ":" + header.second;
-                    packed_headers.push_back( godot::String( hs.c_str() ) );
+                    ++it;
+                    continue;
                 }
-                packed_headers.push_back( "User-Agent: " + userAgent );
-                packed_headers.push_back( "Accept: */*" );
+                ( *it )->lastProgress = now;
+                pConnection->pRequest = std::move( *it );
+                it = this->_pendingRequests.erase( it );
+            }
+        }
+
+        // Rejected outside the lock, as continuations may queue new requests.
+        for ( std::unique_ptr<HttpRequest> &pRequest : timedOut )
+        {
+            pRequest->promise.reject(
+                std::runtime_error( "Request timed out in queue: " + pRequest->url ) );
+        }
+    }
+
+    GodotAssetAccessor::HttpConnection *GodotAssetAccessor::acquireConnection(
+        const HttpRequest &request )
+    {
+        int32_t hostConnections = 0;
+        for ( const std::unique_ptr<HttpConnection> &pConnection : this->_connections )
+        {
+            if ( pConnection->host != request.host || pConnection->port != request.port ||
+                 pConnection->useTls != request.useTls )
+            {
+                continue;
+            }
+            if ( !pConnection->pRequest )
+            {
+                return pConnection.get();
+            }
+            ++hostConnections;
+        }
+
+        if ( hostConnections >= this->_maximumConnectionsPerHost )
+        {
+            return nullptr;
+        }
+
+        auto pConnection = std::make_unique<HttpConnection>();
+        pConnection->client.instantiate();
+        pConnection->host = request.host;
+        pConnection->port = request.port;
+        pConnection->useTls = request.useTls;
+        return this->_connections.emplace_back( std::move( pConnection ) ).get();
+    }
+
+    void GodotAssetAccessor::pollConnection( HttpConnection &connection )
+    {
+        HttpRequest &request = *connection.pRequest;
+        if ( connection.client->get_status() != HTTPClient::STATUS_DISCONNECTED )
+        {
+            connection.client->poll();
+        }
 
-                UtilityFunctions::print( "Requrest url -> ", _path );
+        // Step through as many states as possible without waiting on I/O, e.g. a reused
+        // keep-alive connection goes from Connect to ReceivingHeaders in one tick.
+        const auto now = std::chrono::steady_clock::now();
+        while ( request.state != HttpRequestState::Done &&
+                request.state != HttpRequestState::Failed )
+        {
+            HttpRequestState previous = request.state;
+            request.state = this->advanceRequest( connection );
+            if ( request.state == previous )
+            {
+                break;
+            }
+            request.lastProgress = now;
+        }
+
+        if ( request.state != HttpRequestState::Done &&
+             request.state != HttpRequestState::Failed &&
+             now - request.lastProgress > this->_requestTimeout )
+        {
+            request.state = this->fail( request, "Request timed out" );
+        }
+
+        if ( request.state == HttpRequestState::Done || request.state == HttpRequestState::Failed )
+        {
+            this->completeRequest( connection );
+        }
+    }
 
-                godot::Error err =
-                    httpClient->request( HTTPClient::METHOD_GET, _path, packed_headers );
+    GodotAssetAccessor::HttpRequestState GodotAssetAccessor::advanceRequest(
+        HttpConnection &connection )
+    {
+        HTTPClient *client = connection.client.ptr();
+        HttpRequest &request = *connection.pRequest;
+        HTTPClient::Status status = client->get_status();
 
+        switch ( request.state )
+        {
+            case HttpRequestState::Connect:
+            {
+                if ( status == HTTPClient::STATUS_CONNECTED )
+                {
+                    // Idle keep-alive connection; the server may have closed it meanwhile.
+                    request.reusedConnection = true;
+                    return HttpRequestState::Send;
+                }
+                request.reusedConnection = false;
+                if ( status != HTTPClient::STATUS_DISCONNECTED )
+                {
+                    client->close();
+                }
+                Ref<TLSOptions> tlsOptions;
+                if ( connection.useTls )
+                {
+                    tlsOptions = TLSOptions::client();
+                }
+                godot::Error err = client->connect_to_host(
+                    String::utf8( connection.host.c_str() ), connection.port, tlsOptions );
                 if ( err != Error::OK )
                 {
-                    promise.reject( std::runtime_error( "Request failed." ) );
+                    return this->fail( request, "Connect to host failed" );
                 }
-
-                while ( httpClient->get_status() == HTTPClient::STATUS_REQUESTING )
+                return HttpRequestState::Resolving;
+            }
+            case HttpRequestState::Resolving:
+                switch ( status )
                 {
-                    httpClient->poll();
-                    UtilityFunctions::print( "Requesting..." );
+                    case HTTPClient::STATUS_RESOLVING:
+                        return HttpRequestState::Resolving;
+                    case HTTPClient::STATUS_CONNECTING:
+                        return HttpRequestState::Connecting;
+                    case HTTPClient::STATUS_CONNECTED:
+                        return HttpRequestState::Send;
+                    case HTTPClient::STATUS_CANT_RESOLVE:
+                        return this->fail( request, "Can't resolve host" );
+                    default:
+                        return this->fail( request, "Connection error" );
                 }
-
-                status = httpClient->get_status();
-                UtilityFunctions::print( " Request status -> ", status );
-
-                if ( status == HTTPClient::STATUS_CONNECTED || status == HTTPClient::STATUS_BODY )
+            case HttpRequestState::Connecting:
+                switch ( status )
                 {
-
-                    if ( httpClient->has_response() )
+                    case HTTPClient::STATUS_CONNECTING:
+                        return HttpRequestState::Connecting;
+                    case HTTPClient::STATUS_CONNECTED:
+                        return HttpRequestState::Send;
+                    case HTTPClient::STATUS_CANT_CONNECT:
+                        return this->fail( request, "Can't connect to host" );
+                    case HTTPClient::STATUS_TLS_HANDSHAKE_ERROR:
+                        return this->fail( request, "TLS handshake error" );
+                    default:
+                        return this->fail( request, "Connection error" );
+                }
+            case HttpRequestState::Send:
+            {
+                godot::Error err = client->request_raw( request.httpMethod, request.path,
+                                                        request.requestHeaders, request.body );
+                if ( err != Error::OK )
+                {
+                    return this->fail( request, "Request failed" );
+                }
+                return HttpRequestState::ReceivingHeaders;
+            }
+            case HttpRequestState::ReceivingHeaders:
+                switch ( status )
+                {
+                    case HTTPClient::STATUS_REQUESTING:
+                        return HttpRequestState::ReceivingHeaders;
+                    case HTTPClient::STATUS_BODY:
                     {
-                        PackedByteArray rb;
-                        while ( httpClient->get_status() == HTTPClient::STATUS_BODY )
+                        this->readResponseHead( connection );
+                        // Size the body once from Content-Length; chunked or unknown-length
+                        // bodies grow geometrically instead.
+                        int64_t contentLength = client->get_response_body_length();
+                        if ( contentLength > 0 )
                         {
-                            httpClient->poll();
-                            PackedByteArray chunk = httpClient->read_response_body_chunk();
-                            if ( chunk.size() != 0 )
-                            {
-                                rb.append_array( chunk );
-                            }
+                            request.response.data.resize( contentLength );
                         }
-
-                        AHttpResponse pResponse;
-                        pResponse.code = httpClient->get_response_code();
-                        pResponse.headers = httpClient->get_response_headers_as_dictionary();
-                        pResponse.data = rb;
-
-                        UtilityFunctions::print( "Response code: ", pResponse.code );
-                        promise.resolve( std::make_unique<GodotAssetRequest>(
-                            "GET", url, cesiumRequestHeaders, std::move( pResponse ) ) );
+                        request.bodySize = 0;
+                        return HttpRequestState::ReceivingBody;
+                    }
+                    case HTTPClient::STATUS_CONNECTED:
+                        if ( !client->has_response() )
+                        {
+                            return this->fail( request, "No response" );
+                        }
+                        // Response without a body.
+                        this->readResponseHead( connection );
+                        return HttpRequestState::Done;
+                    default:
+                        if ( request.reusedConnection )
+                        {
+                            // The keep-alive connection went stale; retry once on a fresh one.
+                            return HttpRequestState::Connect;
+                        }
+                        return this->fail( request, "Connection closed by host" );
+                }
+            case HttpRequestState::ReceivingBody:
+            {
+                if ( status == HTTPClient::STATUS_BODY )
+                {
+                    PackedByteArray chunk = client->read_response_body_chunk();
+                    while ( chunk.size() > 0 )
+                    {
+                        PackedByteArray &body = request.response.data;
+                        const int64_t required = request.bodySize + chunk.size();
+                        if ( required > body.size() )
+                        {
+                            body.resize( std::max( required, body.size() * 2 ) );
+                        }
+                        std::memcpy( body.ptrw() + request.bodySize, chunk.ptr(), chunk.size() );
+                        request.bodySize = required;
+                        request.lastProgress = std::chrono::steady_clock::now();
+                        // A fast connection could otherwise keep the loop busy well past the
+                        // tick's budget; the rest of the body is read next tick.
+                        if ( client->get_status() != HTTPClient::STATUS_BODY ||
+                             request.lastProgress > this->_tickDeadline )
+                        {
+                            break;
+                        }
+                        chunk = client->read_response_body_chunk();
                     }
+                    status = client->get_status();
                 }
-                promise.reject( std::runtime_error( "Requesting error or no response." ) );
-            } );
+                switch ( status )
+                {
+                    case HTTPClient::STATUS_BODY:
+                        return HttpRequestState::ReceivingBody;
+                    case HTTPClient::STATUS_CONNECTED:
+                    case HTTPClient::STATUS_DISCONNECTED:
+                        // DISCONNECTED: the server closed the connection to end the body.
+                        if ( request.response.data.size() != request.bodySize )
+                        {
+                            request.response.data.resize( request.bodySize );
+                        }
+                        return HttpRequestState::Done;
+                    default:
+                        return this->fail( request, "Connection error" );
+                }
+            }
+            case HttpRequestState::Done:
+            case HttpRequestState::Failed:
+            default:
+                return request.state;
+        }
     }
 
-    CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> GodotAssetAccessor::request(
-        const CesiumAsync::AsyncSystem &asyncSystem, const std::string &verb,
-        const std::string &url, const std::vector<THeader> &headers,
-        const std::span<const std::byte> &contentPayload )
+    void GodotAssetAccessor::readResponseHead( HttpConnection &connection )
     {
-        AHttpResponse pResponse;
-        std::shared_ptr<CesiumAsync::IAssetRequest> value = std::make_shared<GodotAssetRequest>(
-            verb, url, CesiumAsync::HttpHeaders{}, std::move( pResponse ) );
-        CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>> result =
-            asyncSystem.createResolvedFuture(
-                std::shared_ptr<CesiumAsync::IAssetRequest>( value ) );
-        return result;
+        HTTPClient *client = connection.client.ptr();
+        AHttpResponse &response = connection.pRequest->response;
+        response.code = client->get_response_code();
+        response.headers = client->get_response_headers_as_dictionary();
     }
 
-    void GodotAssetAccessor::tick() noexcept
+    GodotAssetAccessor::HttpRequestState GodotAssetAccessor::fail( HttpRequest &request,
+                                                                   const std::string &message )
+    {
+        request.error = message;
+        return HttpRequestState::Failed;
+    }
+
+    void GodotAssetAccessor::completeRequest( HttpConnection &connection )
     {
+        std::unique_ptr<HttpRequest> pRequest = std::move( connection.pRequest );
+        if ( pRequest->state == HttpRequestState::Done )
+        {
+            pRequest->promise.resolve( std::make_shared<GodotAssetRequest>(
+                pRequest->method, pRequest->url, pRequest->headers,
+                std::move( pRequest->response ) ) );
+        }
+        else
+        {
+            connection.client->close();
+            pRequest->promise.reject(
+                std::runtime_error( pRequest->error + ": " + pRequest->url ) );
+        }
+    }
+
+    void GodotAssetAccessor::closeSurplusConnections()
+    {
+        // Lowering the connection limit only takes effect once connections go idle.
+        std::unordered_map<std::string, int32_t> hostConnections;
+        for ( auto it = this->_connections.begin(); it != this->_connections.end(); )
+        {
+            HttpConnection &connection = **it;
+            std::string key = connection.host + ":" + std::to_string( connection.port ) +
+                              ( connection.useTls ? "s" : "" );
+            int32_t &count = hostConnections[key];
+            if ( connection.pRequest || count < this->_maximumConnectionsPerHost )
+            {
+                ++count;
+                ++it;
+                continue;
+            }
+            connection.client->close();
+            it = this->_connections.erase( it );
+        }
     }
 
 } // namespace CesiumForGodot
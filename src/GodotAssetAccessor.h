@@ -8,6 +8,12 @@
 #include <godot_cpp/classes/http_request.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace CesiumForGodot
 {
     struct AHttpResponse
@@ -17,6 +23,17 @@ namespace CesiumForGodot
         godot::PackedByteArray data;
     };
 
+    /**
+     * Loads tile content from local files and over HTTP(S).
+     *
+     * HTTP requests are queued by get()/request(), which may be called from any thread, and are
+     * driven without blocking from tick() on the main thread. Each host gets a pool of keep-alive
+     * HTTPClient connections; a queued request is handed to the first idle connection for its
+     * host, or opens a new one while the host is below the connection limit.
+     *
+     * Every in-flight request is an explicit state machine (see HttpRequestState) that tick()
+     * advances as far as it can without waiting on I/O, within a per-frame time budget.
+     */
     class GodotAssetAccessor : public CesiumAsync::IAssetAccessor
     {
     public:
@@ -33,12 +50,93 @@ namespace CesiumForGodot
 
         virtual void tick() noexcept override;
 
+        void setMaximumConnectionsPerHost( int32_t maximumConnections );
+        int32_t getMaximumConnectionsPerHost() const;
+
+        void setTickTimeBudget( double milliseconds );
+        double getTickTimeBudget() const;
+
+        void setRequestTimeout( double seconds );
+        double getRequestTimeout() const;
+
     private:
+        // Lifecycle of a request once it owns a connection. Done and Failed are terminal.
+        enum class HttpRequestState
+        {
+            Connect,
+            Resolving,
+            Connecting,
+            Send,
+            ReceivingHeaders,
+            ReceivingBody,
+            Done,
+            Failed,
+        };
+
+        struct HttpRequest
+        {
+            HttpRequest( CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>> &&p ) :
+                promise( std::move( p ) )
+            {
+            }
+
+            std::string method;
+            std::string url;
+            CesiumAsync::HttpHeaders headers;
+            godot::HTTPClient::Method httpMethod = godot::HTTPClient::METHOD_GET;
+            std::string host;
+            int32_t port = 80;
+            bool useTls = false;
+            godot::String path;
+            godot::PackedStringArray requestHeaders;
+            godot::PackedByteArray body;
+            CesiumAsync::Promise<std::shared_ptr<CesiumAsync::IAssetRequest>> promise;
+
+            HttpRequestState state = HttpRequestState::Connect;
+            bool reusedConnection = false;
+            // When the request was queued, and when it last moved on once it has a connection.
+            std::chrono::steady_clock::time_point queued;
+            std::chrono::steady_clock::time_point lastProgress;
+            std::string error;
+            AHttpResponse response;
+            int64_t bodySize = 0;
+        };
+
+        struct HttpConnection
+        {
+            godot::Ref<godot::HTTPClient> client;
+            std::string host;
+            int32_t port = 80;
+            bool useTls = false;
+
+            std::unique_ptr<HttpRequest> pRequest;
+        };
+
+        void assignPendingRequests();
+        HttpConnection *acquireConnection( const HttpRequest &request );
+        void pollConnection( HttpConnection &connection );
+        HttpRequestState advanceRequest( HttpConnection &connection );
+        void readResponseHead( HttpConnection &connection );
+        HttpRequestState fail( HttpRequest &request, const std::string &message );
+        void completeRequest( HttpConnection &connection );
+        void closeSurplusConnections();
+
         CesiumAsync::HttpHeaders _cesiumRequestHeaders;
         godot::String _userAgent;
-        godot::Ref<godot::HTTPClient> _http_client;
+        int32_t _maximumConnectionsPerHost;
+        std::chrono::microseconds _tickTimeBudget;
+        std::chrono::milliseconds _requestTimeout;
+        size_t _nextConnection;
+        // The end of the current tick's time budget.
+        std::chrono::steady_clock::time_point _tickDeadline;
+
+        std::mutex _pendingMutex;
+        std::deque<std::unique_ptr<HttpRequest>> _pendingRequests;
+
+        // Only touched from tick(), on the main thread.
+        std::vector<std::unique_ptr<HttpConnection>> _connections;
     };
 
 } // namespace CesiumForGodot
 
-#endif
\ No newline at end of file
+#endif
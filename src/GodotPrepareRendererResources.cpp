@@ -2,7 +2,13 @@
 #include <CesiumGltf/AccessorView.h>
 #include <algorithm>
 
+#include <godot_cpp/classes/physics_server3d.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
 #include <godot_cpp/classes/standard_material3d.hpp>
+#include <godot_cpp/classes/world3d.hpp>
+
+#include <functional>
+#include <limits>
 
 using namespace CesiumForGodot;
 using namespace CesiumRasterOverlays;
@@ -13,35 +19,117 @@ using namespace CesiumGeospatial;
 using namespace CesiumGltf;
 using namespace CesiumUtility;
 
+// Decoded images of a model's textures, keyed by the image they were decoded from.
+using DecodedImages = std::unordered_map<const CesiumGltf::ImageAsset *, Ref<godot::Image>>;
+
 struct LoadThreadResult
 {
-    std::vector<Ref<ArrayMesh>> meshes;
+    Ref<ArrayMesh> mesh;
     std::vector<CesiumPrimitiveInfo> primitiveInfos{};
+    DecodedImages images{};
+    RID collisionShape{};
+
+    ~LoadThreadResult()
+    {
+        // Only still set if the tile was freed before prepareInMainThread took the shape.
+        if ( collisionShape.is_valid() )
+        {
+            PhysicsServer3D::get_singleton()->free_rid( collisionShape );
+        }
+    }
 };
 
-bool isDegenerateTriangleMesh( const Ref<ArrayMesh> mesh )
+void CesiumGltfNode::set_visible( bool b )
 {
-    Array surface_array = mesh->surface_get_arrays( 0 );
-    PackedVector3Array vertices = surface_array[ArrayMesh::ARRAY_VERTEX];
-    int32_t vertexCount = vertices.size();
-    if ( vertexCount < 3 )
+    if ( visible == b )
+    {
+        return;
+    }
+    if ( pNode )
+    {
+        pNode->set_visible( b );
+    }
+    if ( instance.is_valid() )
     {
-        return true;
+        RenderingServer::get_singleton()->instance_set_visible( instance, b && tilesetVisible );
     }
+    visible = b;
+}
 
-    if ( vertexCount == 3 )
+void CesiumGltfNode::update_server_objects( const Transform3D &tilesetTransform,
+                                            bool p_tilesetVisible )
+{
+    if ( instance.is_valid() )
+    {
+        RenderingServer *renderingServer = RenderingServer::get_singleton();
+        renderingServer->instance_set_transform( instance, tilesetTransform * localTransform );
+        tilesetVisible = p_tilesetVisible;
+        renderingServer->instance_set_visible( instance, visible && tilesetVisible );
+    }
+    if ( collision.body.is_valid() )
     {
-        godot::Vector3 Vertex0 = vertices[0];
-        godot::Vector3 Vertex1 = vertices[1];
-        godot::Vector3 Vertex2 = vertices[2];
+        PhysicsServer3D::get_singleton()->body_set_state( collision.body,
+                                                          PhysicsServer3D::BODY_STATE_TRANSFORM,
+                                                          tilesetTransform * localTransform );
+    }
+}
+
+void CesiumGltfCollision::create_body( const Transform3D &transform, const RID &space )
+{
+    PhysicsServer3D *physicsServer = PhysicsServer3D::get_singleton();
+    body = physicsServer->body_create();
+    physicsServer->body_set_mode( body, PhysicsServer3D::BODY_MODE_STATIC );
+    physicsServer->body_add_shape( body, shape );
+    physicsServer->body_set_state( body, PhysicsServer3D::BODY_STATE_TRANSFORM, transform );
+    physicsServer->body_set_space( body, space );
+}
 
-        const real_t EPSILON = 1e-5f;
-        return ( Vertex0.distance_to( Vertex1 ) < EPSILON ) ||
-               ( Vertex1.distance_to( Vertex2 ) < EPSILON ) ||
-               ( Vertex2.distance_to( Vertex0 ) < EPSILON );
+void CesiumGltfCollision::free_body()
+{
+    if ( body.is_valid() )
+    {
+        PhysicsServer3D::get_singleton()->free_rid( body );
+        body = RID();
+    }
+}
+
+void CesiumGltfNode::update_collision( bool wanted, const Transform3D &tilesetTransform,
+                                       const RID &space )
+{
+    if ( !wanted )
+    {
+        collision.free_body();
+        return;
+    }
+    if ( collision.body.is_valid() )
+    {
+        return;
+    }
+    if ( !collision.shape.is_valid() && !collision.shapeRebuilt )
+    {
+        rebuild_collision_shape();
+    }
+    if ( collision.shape.is_valid() )
+    {
+        collision.create_body( tilesetTransform * localTransform, space );
     }
+}
 
-    return false;
+void CesiumGltfNode::free_server_objects()
+{
+    if ( instance.is_valid() )
+    {
+        RenderingServer::get_singleton()->free_rid( instance );
+        instance = RID();
+    }
+    mesh.unref();
+    // The body goes first, so the shape is no longer in use when it is freed.
+    collision.free_body();
+    if ( collision.shape.is_valid() )
+    {
+        PhysicsServer3D::get_singleton()->free_rid( collision.shape );
+        collision.shape = RID();
+    }
 }
 
 int32_t countPrimitives( const CesiumGltf::Model &model )
@@ -102,195 +190,155 @@ void generateMipMapsForPrimitive( CesiumGltf::Model *pModel,
     }
 }
 
-template <typename TIndex> std::vector<TIndex> generateIndices( const int32_t count )
+// Godot stores a surface's indices as uint16 exactly when it has at most this many vertices.
+const int32_t maximumShortIndexVertexCount = 1 << 16;
+
+/**
+ * Appends the triangles of a surface built by loadPrimitive to a list of collision faces. A
+ * surface with an index beyond its vertices adds no faces.
+ */
+template <typename TIndex>
+void appendCollisionFaces( PackedVector3Array &faces, const PackedByteArray &vertexData,
+                           int64_t vertexCount, const PackedByteArray &indexData,
+                           int64_t indexCount )
 {
-    std::vector<TIndex> syntheticIndexBuffer( count );
-    for ( int64_t i = 0; i < count; ++i )
+    // Positions come first in vertex_data; the indices already have Godot's winding order.
+    const glm::vec3 *pPositions = reinterpret_cast<const glm::vec3 *>( vertexData.ptr() );
+    const TIndex *pIndices = reinterpret_cast<const TIndex *>( indexData.ptr() );
+    if ( vertexData.size() < vertexCount * int64_t( sizeof( glm::vec3 ) ) ||
+         indexData.size() < indexCount * int64_t( sizeof( TIndex ) ) )
     {
-        syntheticIndexBuffer[i] = static_cast<TIndex>( i );
+        return;
     }
-    return syntheticIndexBuffer;
-}
-
-bool validateVertexColors( const CesiumGltf::Model &model, uint32_t accessorId, size_t vertexCount )
-{
-    if ( accessorId >= model.accessors.size() )
+    for ( int64_t i = 0; i < indexCount; ++i )
     {
-        return false;
+        if ( pIndices[i] >= vertexCount )
+        {
+            SPDLOG_WARN( "Skipping collision for a surface with vertex index {} out of range.",
+                         int64_t( pIndices[i] ) );
+            return;
+        }
     }
 
-    const CesiumGltf::Accessor &colorAccessor = model.accessors[accessorId];
-    if ( colorAccessor.type != CesiumGltf::Accessor::Type::VEC3 &&
-         colorAccessor.type != CesiumGltf::Accessor::Type::VEC4 )
+    const int64_t offset = faces.size();
+    faces.resize( offset + indexCount );
+    Vector3 *pFaces = faces.ptrw() + offset;
+    for ( int64_t i = 0; i < indexCount; ++i )
     {
-        return false;
+        const glm::vec3 &position = pPositions[pIndices[i]];
+        pFaces[i] = Vector3( position.x, position.y, position.z );
     }
+}
 
-    if ( colorAccessor.componentType != CesiumGltf::Accessor::ComponentType::UNSIGNED_BYTE &&
-         colorAccessor.componentType != CesiumGltf::Accessor::ComponentType::UNSIGNED_SHORT &&
-         colorAccessor.componentType != CesiumGltf::Accessor::ComponentType::FLOAT )
+void appendCollisionFaces( PackedVector3Array &faces, const Dictionary &surface )
+{
+    if ( static_cast<int64_t>( surface["primitive"] ) != RenderingServer::PRIMITIVE_TRIANGLES )
     {
-        return false;
+        return;
     }
-
-    if ( static_cast<size_t>( colorAccessor.count ) < vertexCount )
+    const int64_t vertexCount = surface["vertex_count"];
+    const int64_t indexCount = surface["index_count"];
+    const PackedByteArray vertexData = surface["vertex_data"];
+    const PackedByteArray indexData = surface["index_data"];
+    if ( vertexCount <= maximumShortIndexVertexCount )
     {
-        return false;
+        appendCollisionFaces<uint16_t>( faces, vertexData, vertexCount, indexData, indexCount );
+    }
+    else
+    {
+        appendCollisionFaces<uint32_t>( faces, vertexData, vertexCount, indexData, indexCount );
     }
-
-    return true;
 }
-template <typename TIndex> struct CopyVertexColors
-{
-    uint8_t *pWritePos;
-    size_t stride;
-    size_t vertexCount;
-    bool duplicateVertices;
-    TIndex *indices;
-
-    struct Color32
-    {
-        uint8_t r;
-        uint8_t g;
-        uint8_t b;
-        uint8_t a;
-    };
 
-    bool operator()( AccessorView<nullptr_t> &&invalidView )
+/**
+ * Creates a concave shape from a list of collision faces, or returns an invalid RID if there
+ * are no faces.
+ */
+RID createCollisionShape( const PackedVector3Array &faces )
+{
+    if ( faces.size() < 3 )
     {
-        return false;
+        return RID();
     }
+    PhysicsServer3D *physicsServer = PhysicsServer3D::get_singleton();
+    RID shape = physicsServer->concave_polygon_shape_create();
+    Dictionary shapeData;
+    shapeData["faces"] = faces;
+    shapeData["backface_collision"] = false;
+    physicsServer->shape_set_data( shape, shapeData );
+    return shape;
+}
 
-    template <typename TColorView> bool operator()( TColorView &&colorView )
+void CesiumGltfNode::rebuild_collision_shape()
+{
+    collision.shapeRebuilt = true;
+    Ref<ArrayMesh> arrayMesh = mesh;
+    if ( arrayMesh.is_null() && pNode )
     {
-        if ( colorView.status() != AccessorViewStatus::Valid )
-        {
-            return false;
-        }
-
-        bool success = true;
-        if ( duplicateVertices )
-        {
-            for ( size_t i = 0; success && i < vertexCount; ++i )
-            {
-                TIndex vertexIndex = indices[i];
-                if ( vertexIndex < 0 || vertexIndex >= colorView.size() )
-                {
-                    success = false;
-                }
-                else
-                {
-                    Color32 &packedColor = *reinterpret_cast<Color32 *>( pWritePos );
-                    success = CopyVertexColors::convertColor( colorView[vertexIndex], packedColor );
-                    pWritePos += stride;
-                }
-            }
-        }
-        else
-        {
-            for ( size_t i = 0; success && i < vertexCount; ++i )
-            {
-                if ( i >= static_cast<size_t>( colorView.size() ) )
-                {
-                    success = false;
-                }
-                else
-                {
-                    Color32 &packedColor = *reinterpret_cast<Color32 *>( pWritePos );
-                    success = CopyVertexColors::convertColor( colorView[i], packedColor );
-                    pWritePos += stride;
-                }
-            }
-        }
-
-        return success;
+        arrayMesh = pNode->get_mesh();
     }
-
-    bool packColorChannel( uint8_t c, uint8_t &result )
+    if ( arrayMesh.is_null() )
     {
-        result = c;
-        return true;
+        return;
     }
-
-    bool packColorChannel( uint16_t c, uint8_t &result )
+    // The surfaces are still in the layout loadPrimitive built them in.
+    const Array surfaces = arrayMesh->get( "_surfaces" );
+    PackedVector3Array faces;
+    for ( int64_t i = 0; i < surfaces.size(); ++i )
     {
-        result = static_cast<uint8_t>( c >> 8 );
-        return true;
+        appendCollisionFaces( faces, surfaces[i] );
     }
+    collision.shape = createCollisionShape( faces );
+}
+
+template <typename T> bool isValidIndexView( const AccessorView<T> &view )
+{
+    return view.status() == AccessorViewStatus::Valid;
+}
 
-    bool packColorChannel( float c, uint8_t &result )
+template <typename T> bool isValidIndexView( const std::vector<T> & )
+{
+    return true;
+}
+
+template <typename TIndex> std::vector<TIndex> generateIndices( const int32_t count )
+{
+    std::vector<TIndex> syntheticIndexBuffer( count );
+    for ( int64_t i = 0; i < count; ++i )
     {
-        result = static_cast<uint8_t>( static_cast<uint32_t>( 255.0f * c ) & 255 );
-        return true;
+        syntheticIndexBuffer[i] = static_cast<TIndex>( i );
     }
+    return syntheticIndexBuffer;
+}
 
-    template <typename T> bool packColorChannel( T c, uint8_t &result )
+bool validateVertexColors( const CesiumGltf::Model &model, uint32_t accessorId, size_t vertexCount )
+{
+    if ( accessorId >= model.accessors.size() )
     {
-        // Invalid accessor type.
         return false;
     }
 
-    template <typename TChannel>
-    bool convertColor( const AccessorTypes::VEC3<TChannel> &color, Color32 &result )
+    const CesiumGltf::Accessor &colorAccessor = model.accessors[accessorId];
+    if ( colorAccessor.type != CesiumGltf::Accessor::Type::VEC3 &&
+         colorAccessor.type != CesiumGltf::Accessor::Type::VEC4 )
     {
-        result.a = 255;
-        return packColorChannel( color.value[0], result.r ) &&
-               packColorChannel( color.value[1], result.g ) &&
-               packColorChannel( color.value[2], result.b );
+        return false;
     }
 
-    template <typename TChannel>
-    bool convertColor( const AccessorTypes::VEC4<TChannel> &color, Color32 &result )
+    if ( colorAccessor.componentType != CesiumGltf::Accessor::ComponentType::UNSIGNED_BYTE &&
+         colorAccessor.componentType != CesiumGltf::Accessor::ComponentType::UNSIGNED_SHORT &&
+         colorAccessor.componentType != CesiumGltf::Accessor::ComponentType::FLOAT )
     {
-        return packColorChannel( color.value[0], result.r ) &&
-               packColorChannel( color.value[1], result.g ) &&
-               packColorChannel( color.value[2], result.b ) &&
-               packColorChannel( color.value[3], result.a );
+        return false;
     }
 
-    template <typename T> bool convertColor( T color, Color32 &result )
+    if ( static_cast<size_t>( colorAccessor.count ) < vertexCount )
     {
-        // Not an accessor
         return false;
     }
-};
 
-int32_t computeVertexDataSize( int32_t vertexCount, VertexAttributeDescriptor *attributes,
-                               std::int32_t size )
-{
-    int32_t totalSize = 0;
-    for ( int32_t i = 0; i < size; ++i )
-    {
-        const auto &attribute = attributes[i];
-        size_t attributeSize = 0;
-        switch ( attribute.format )
-        {
-            case VertexAttributeFormat::Float32:
-            case VertexAttributeFormat::UInt32:
-            case VertexAttributeFormat::SInt32:
-                attributeSize = sizeof( float ) * attribute.dimension;
-                break;
-            case VertexAttributeFormat::Float16:
-            case VertexAttributeFormat::UNorm16:
-            case VertexAttributeFormat::SNorm16:
-            case VertexAttributeFormat::UInt16:
-            case VertexAttributeFormat::SInt16:
-                attributeSize = sizeof( uint16_t ) * attribute.dimension;
-                break;
-            case VertexAttributeFormat::UNorm8:
-            case VertexAttributeFormat::SNorm8:
-            case VertexAttributeFormat::UInt8:
-            case VertexAttributeFormat::SInt8:
-                attributeSize = sizeof( uint8_t ) * attribute.dimension;
-                break;
-            default:
-                break;
-        }
-        totalSize += attributeSize;
-    }
-    return totalSize * vertexCount;
+    return true;
 }
-
 godot::Image::Format getUncompressedPixelFormat( const CesiumGltf::ImageAsset &image )
 {
     switch ( image.channels )
@@ -321,9 +369,9 @@ godot::Image::Format getCompressedPixelFormat( const CesiumGltf::ImageAsset &ima
         case GpuCompressedPixelFormat::ETC2_RGBA:
             return godot::Image::Format::FORMAT_ETC2_RGBA8;
         case GpuCompressedPixelFormat::BC1_RGB:
-            return godot::Image::Format::FORMAT_RGB8;
+            return godot::Image::Format::FORMAT_DXT1;
         case GpuCompressedPixelFormat::BC3_RGBA:
-            return godot::Image::Format::FORMAT_RGBA4444;
+            return godot::Image::Format::FORMAT_DXT5;
         case GpuCompressedPixelFormat::BC4_R:
             return godot::Image::Format::FORMAT_RGTC_R;
         case GpuCompressedPixelFormat::BC5_RG:
@@ -332,28 +380,63 @@ godot::Image::Format getCompressedPixelFormat( const CesiumGltf::ImageAsset &ima
             return godot::Image::Format::FORMAT_BPTC_RGBA;
         case GpuCompressedPixelFormat::ASTC_4x4_RGBA:
             return godot::Image::Format::FORMAT_ASTC_4x4;
-        case GpuCompressedPixelFormat::PVRTC1_4_RGB:
-            return godot::Image::Format::FORMAT_RGB8;
-        case GpuCompressedPixelFormat::PVRTC1_4_RGBA:
-            return godot::Image::Format::FORMAT_RGBA4444;
         case GpuCompressedPixelFormat::ETC2_EAC_R11:
             return godot::Image::Format::FORMAT_ETC2_R11;
         case GpuCompressedPixelFormat::ETC2_EAC_RG11:
             return godot::Image::Format::FORMAT_ETC2_RG11;
-        case GpuCompressedPixelFormat::PVRTC2_4_RGB:
-        case GpuCompressedPixelFormat::PVRTC2_4_RGBA:
         default:
-            return godot::Image::Format::FORMAT_RGBA8;
+            // Godot 4 has no PVRTC support.
+            return godot::Image::Format::FORMAT_MAX;
     }
 }
 
-Ref<godot::Image> loadImageFromCesiumImage( const CesiumGltf::ImageAsset &imageAsset, bool sRGB )
+bool isGpuCompressedPixelFormatSupported( GpuCompressedPixelFormat format )
+{
+    const SupportedGpuCompressedPixelFormats &supported = getSupportedGpuCompressedPixelFormats();
+    switch ( format )
+    {
+        case GpuCompressedPixelFormat::ETC1_RGB:
+            return supported.ETC1_RGB;
+        case GpuCompressedPixelFormat::ETC2_RGBA:
+            return supported.ETC2_RGBA;
+        case GpuCompressedPixelFormat::BC1_RGB:
+            return supported.BC1_RGB;
+        case GpuCompressedPixelFormat::BC3_RGBA:
+            return supported.BC3_RGBA;
+        case GpuCompressedPixelFormat::BC4_R:
+            return supported.BC4_R;
+        case GpuCompressedPixelFormat::BC5_RG:
+            return supported.BC5_RG;
+        case GpuCompressedPixelFormat::BC7_RGBA:
+            return supported.BC7_RGBA;
+        case GpuCompressedPixelFormat::ASTC_4x4_RGBA:
+            return supported.ASTC_4x4_RGBA;
+        case GpuCompressedPixelFormat::ETC2_EAC_R11:
+            return supported.ETC2_EAC_R11;
+        case GpuCompressedPixelFormat::ETC2_EAC_RG11:
+            return supported.ETC2_EAC_RG11;
+        default:
+            return false;
+    }
+}
+
+// Godot images carry either no mipmaps or a full chain down to 1x1, each level padded to the
+// format's block size, which is also how KTX2 and ImageDecoder::generateMipMaps lay them out.
+int32_t getFullMipChainLength( int32_t width, int32_t height )
+{
+    int32_t levels = 1;
+    for ( int32_t size = std::max( width, height ); size > 1; size >>= 1 )
+    {
+        ++levels;
+    }
+    return levels;
+}
+
+Ref<godot::Image> loadImageFromCesiumImage( const CesiumGltf::ImageAsset &imageAsset )
 {
     int32_t width = imageAsset.width;
     int32_t height = imageAsset.height;
-    int32_t channels = imageAsset.channels;
     godot::Image::Format format;
-    Ref<godot::Image> image;
 
     if ( imageAsset.compressedPixelFormat == GpuCompressedPixelFormat::NONE )
     {
@@ -363,394 +446,317 @@ Ref<godot::Image> loadImageFromCesiumImage( const CesiumGltf::ImageAsset &imageA
     {
         format = getCompressedPixelFormat( imageAsset );
     }
-    std::vector<uint8_t> pixelDataBuffer( width * height * channels * imageAsset.bytesPerChannel );
 
+    const std::vector<std::byte> &pixelData = imageAsset.pixelData;
+    const bool hasMipmaps = imageAsset.mipPositions.size() > 1 &&
+                            static_cast<int32_t>( imageAsset.mipPositions.size() ) ==
+                                getFullMipChainLength( width, height );
+
+    godot::PackedByteArray packedData;
     if ( imageAsset.mipPositions.empty() )
     {
-        std::memcpy( pixelDataBuffer.data(), imageAsset.pixelData.data(),
-                     imageAsset.pixelData.size() );
-
-        godot::PackedByteArray packedData;
-        packedData.resize( pixelDataBuffer.size() );
-        std::memcpy( packedData.ptrw(), pixelDataBuffer.data(), pixelDataBuffer.size() );
-        image.instantiate();
-        image->set_data( width, height, false, format, packedData );
+        packedData.resize( pixelData.size() );
+        std::memcpy( packedData.ptrw(), pixelData.data(), pixelData.size() );
     }
     else
     {
-        size_t totalMipSize = 0;
-        for ( const auto &mip : imageAsset.mipPositions )
-        {
-            totalMipSize += mip.byteSize;
-        }
-
-        if ( totalMipSize > pixelDataBuffer.size() )
+        // A partial chain can't be handed to Godot, so only the base level is used then.
+        size_t mipCount = hasMipmaps ? imageAsset.mipPositions.size() : 1;
+        size_t totalSize = 0;
+        for ( size_t i = 0; i < mipCount; ++i )
         {
-            pixelDataBuffer.resize( totalMipSize, 0 );
+            totalSize += imageAsset.mipPositions[i].byteSize;
         }
 
-        uint8_t *writePos = pixelDataBuffer.data();
-        for ( const auto &mip : imageAsset.mipPositions )
+        packedData.resize( totalSize );
+        uint8_t *writePos = packedData.ptrw();
+        for ( size_t i = 0; i < mipCount; ++i )
         {
-            std::memcpy( writePos, imageAsset.pixelData.data() + mip.byteOffset, mip.byteSize );
+            const auto &mip = imageAsset.mipPositions[i];
+            std::memcpy( writePos, pixelData.data() + mip.byteOffset, mip.byteSize );
             writePos += mip.byteSize;
         }
-
-        godot::PackedByteArray packedData;
-        packedData.resize( imageAsset.mipPositions[0].byteSize );
-        std::memcpy( packedData.ptrw(), pixelDataBuffer.data(),
-                     imageAsset.mipPositions[0].byteSize );
-
-        image.instantiate();
-        image->set_data( width, height, false, format, packedData );
     }
 
+    Ref<godot::Image> image;
+    if ( format == godot::Image::Format::FORMAT_MAX )
+    {
+        // Not reachable for KTX2 textures, which cesium-native only transcodes to formats from
+        // getSupportedGpuCompressedPixelFormats() or to RGBA.
+        SPDLOG_WARN( "Dropping texture in GPU compressed pixel format {}, which Godot can't "
+                     "load or decompress.",
+                     static_cast<int32_t>( imageAsset.compressedPixelFormat ) );
+        return image;
+    }
+    image.instantiate();
+    image->set_data( width, height, hasMipmaps, format, packedData );
+
+    // Images that arrive already compressed (rather than transcoded by cesium-native to a
+    // format from getSupportedGpuCompressedPixelFormats()) may use a format the GPU can't
+    // sample; decompress those on the CPU here rather than letting the upload fail.
+    if ( imageAsset.compressedPixelFormat != GpuCompressedPixelFormat::NONE &&
+         !isGpuCompressedPixelFormatSupported( imageAsset.compressedPixelFormat ) &&
+         image->decompress() != godot::Error::OK )
+    {
+        SPDLOG_WARN( "Dropping texture in GPU compressed pixel format {}, which failed to "
+                     "decompress.",
+                     static_cast<int32_t>( imageAsset.compressedPixelFormat ) );
+        return Ref<godot::Image>();
+    }
     return image;
 }
 
-Ref<godot::ImageTexture> loadTexture( const CesiumGltf::Model &model, int32_t textureInfoIndex,
-                                      bool sRGB )
+void loadImage( const CesiumGltf::Model &model,
+                const std::optional<CesiumGltf::TextureInfo> &textureInfo,
+                DecodedImages &images )
 {
-    const CesiumGltf::Texture *pTexture = Model::getSafe( &model.textures, textureInfoIndex );
+    if ( !textureInfo )
+    {
+        return;
+    }
+    const CesiumGltf::Texture *pTexture = Model::getSafe( &model.textures, textureInfo->index );
+    if ( !pTexture )
+    {
+        return;
+    }
     const CesiumGltf::Image *pImage = CesiumGltf::Model::getSafe( &model.images, pTexture->source );
-    if ( !pImage )
+    if ( !pImage || !pImage->pAsset || images.count( pImage->pAsset.get() ) )
+    {
+        return;
+    }
+    images[pImage->pAsset.get()] = loadImageFromCesiumImage( *pImage->pAsset );
+}
+
+/**
+ * Converts the images of every texture the primitive's material uses to godot::Image, so
+ * the main thread only has to create the textures from them.
+ */
+void loadImagesForPrimitive( const CesiumGltf::Model &model,
+                             const CesiumGltf::MeshPrimitive &primitive,
+                             DecodedImages &images )
+{
+    const CesiumGltf::Material *pMaterial =
+        CesiumGltf::Model::getSafe( &model.materials, primitive.material );
+    if ( pMaterial )
     {
-        return Ref<godot::Texture>( nullptr );
+        if ( pMaterial->pbrMetallicRoughness )
+        {
+            loadImage( model, pMaterial->pbrMetallicRoughness->baseColorTexture, images );
+            loadImage( model, pMaterial->pbrMetallicRoughness->metallicRoughnessTexture, images );
+        }
+        loadImage( model, pMaterial->normalTexture, images );
+        loadImage( model, pMaterial->occlusionTexture, images );
+        loadImage( model, pMaterial->emissiveTexture, images );
     }
+}
 
-    const ImageAsset &imageAsset = *pImage->pAsset;
-    Ref<godot::Image> image = loadImageFromCesiumImage( imageAsset, sRGB );
+// Returns the texture for a glTF texture index, or a null reference.
+using TextureLoader = std::function<Ref<ImageTexture>( int32_t textureIndex )>;
 
-    Ref<ImageTexture> godotTexture = ImageTexture::create_from_image( image );
+static const CesiumGltf::MaterialPBRMetallicRoughness defaultPbrMetallicRoughness;
 
-    return godotTexture;
+BaseMaterial3D::TextureFilter getTextureFilter( const CesiumGltf::Sampler &sampler )
+{
+    if ( !sampler.minFilter )
+    {
+        return sampler.magFilter && *sampler.magFilter == Sampler::MagFilter::NEAREST
+                   ? BaseMaterial3D::TEXTURE_FILTER_NEAREST
+                   : BaseMaterial3D::TEXTURE_FILTER_LINEAR;
+    }
+    switch ( *sampler.minFilter )
+    {
+        case Sampler::MinFilter::NEAREST:
+            return BaseMaterial3D::TEXTURE_FILTER_NEAREST;
+        case Sampler::MinFilter::NEAREST_MIPMAP_NEAREST:
+        case Sampler::MinFilter::NEAREST_MIPMAP_LINEAR:
+            return BaseMaterial3D::TEXTURE_FILTER_NEAREST_WITH_MIPMAPS;
+        case Sampler::MinFilter::LINEAR:
+            return BaseMaterial3D::TEXTURE_FILTER_LINEAR;
+        default:
+            return BaseMaterial3D::TEXTURE_FILTER_LINEAR_WITH_MIPMAPS;
+    }
 }
 
-static const CesiumGltf::MaterialPBRMetallicRoughness defaultPbrMetallicRoughness;
-void setGltfMaterialParameterValues( const CesiumGltf::Model &model,
-                                     const CesiumPrimitiveInfo &primitiveInfo,
-                                     const CesiumGltf::Material &gltfMaterial,
-                                     const Ref<StandardMaterial3D> material)
+// Loads the texture of a texture slot, if the primitive has the texture coordinates it uses.
+template <typename TTextureInfo>
+Ref<Texture2D> resolveTexture( const TextureLoader &loadTexture,
+                               const CesiumPrimitiveInfo &primitiveInfo,
+                               const std::optional<TTextureInfo> &textureInfo )
 {
+    if ( !textureInfo ||
+         primitiveInfo.uvIndexMap.find( textureInfo->texCoord ) == primitiveInfo.uvIndexMap.end() )
+    {
+        return Ref<Texture2D>();
+    }
+    return loadTexture( textureInfo->index );
+}
 
+// Godot materials have a single UV transform, so the last valid KHR_texture_transform wins.
+template <typename TTextureInfo>
+void resolveTextureTransform( const std::optional<TTextureInfo> &textureInfo, MaterialKey &key )
+{
+    const CesiumGltf::ExtensionKhrTextureTransform *pTextureTransform =
+        textureInfo ? textureInfo->template getExtension<CesiumGltf::ExtensionKhrTextureTransform>()
+                    : nullptr;
+    if ( !pTextureTransform )
+    {
+        return;
+    }
+    CesiumGltf::KhrTextureTransform textureTransform( *pTextureTransform );
+    if ( textureTransform.status() == CesiumGltf::KhrTextureTransformStatus::Valid )
+    {
+        const glm::dvec2 &scale = textureTransform.scale();
+        const glm::dvec2 &offset = textureTransform.offset();
+        key.uv1Scale = Vector3( scale[0], scale[1], 0 );
+        key.uv1Offset = Vector3( offset[0], offset[1], 0 );
+    }
+}
+
+MaterialKey resolveMaterialKey( const CesiumGltf::Model &model, const TextureLoader &loadTexture,
+                                const CesiumPrimitiveInfo &primitiveInfo,
+                                const CesiumGltf::Material &gltfMaterial )
+{
     CESIUM_TRACE( "Cesium::CreateMaterials" );
     const CesiumGltf::MaterialPBRMetallicRoughness &pbr =
         gltfMaterial.pbrMetallicRoughness ? gltfMaterial.pbrMetallicRoughness.value()
                                           : defaultPbrMetallicRoughness;
 
+    MaterialKey key;
+
     // Add base color factor and metallic-roughness factor regardless
     // of whether the textures are present.
     const std::vector<double> &baseColorFactor = pbr.baseColorFactor;
-    material->set_albedo(
-        Color( baseColorFactor[0], baseColorFactor[1], baseColorFactor[2], baseColorFactor[3] ) );
-    material->set_metallic( pbr.metallicFactor );
-    material->set_roughness( pbr.roughnessFactor );
-
-    const std::optional<CesiumGltf::TextureInfo> &baseColorTexture = pbr.baseColorTexture;
-    if ( baseColorTexture )
-    {
-        auto texCoordIndexIt = primitiveInfo.uvIndexMap.find( baseColorTexture->texCoord );
-        if ( texCoordIndexIt != primitiveInfo.uvIndexMap.end() )
+    key.albedo =
+        Color( baseColorFactor[0], baseColorFactor[1], baseColorFactor[2], baseColorFactor[3] );
+    key.metallic = static_cast<float>( pbr.metallicFactor );
+    key.roughness = static_cast<float>( pbr.roughnessFactor );
+    key.unlit = primitiveInfo.isUnlit;
+
+    key.albedoTexture = resolveTexture( loadTexture, primitiveInfo, pbr.baseColorTexture );
+    if ( key.albedoTexture.is_valid() )
+    {
+        const CesiumGltf::Texture *pTexture =
+            Model::getSafe( &model.textures, pbr.baseColorTexture->index );
+        const CesiumGltf::Sampler *pSampler =
+            pTexture ? Model::getSafe( &model.samplers, pTexture->sampler ) : nullptr;
+        if ( pSampler )
         {
-            Ref<godot::Texture> gTexture = loadTexture( model, baseColorTexture->index, true );
-            if ( gTexture.is_valid() )
-            {
-                material->set_texture( StandardMaterial3D::TextureParam::TEXTURE_ALBEDO, gTexture );
-                const CesiumGltf::Texture *pTexture =
-                    Model::getSafe( &model.textures, baseColorTexture->index );
-                const CesiumGltf::Sampler *pSampler =
-                    CesiumGltf::Model::getSafe( &model.samplers, pTexture->source );
-                if ( pSampler )
-                {
-                    if ( !pSampler->minFilter )
-                    {
-                        if ( pSampler->magFilter &&
-                             *pSampler->magFilter == Sampler::MagFilter::NEAREST )
-                        {
-                            material->set_texture_filter(
-                                BaseMaterial3D::TextureFilter::TEXTURE_FILTER_NEAREST );
-                        }
-                        else
-                        {
-                            material->set_texture_filter(
-                                BaseMaterial3D::TextureFilter::TEXTURE_FILTER_LINEAR );
-                        }
-                    }
-                    else
-                    {
-                        switch ( *pSampler->minFilter )
-                        {
-                            case Sampler::MinFilter::NEAREST:
-                                material->set_texture_filter(
-                                    BaseMaterial3D::TextureFilter::TEXTURE_FILTER_NEAREST );
-                                break;
-                            case Sampler::MinFilter::NEAREST_MIPMAP_NEAREST:
-                                material->set_texture_filter(
-                                    BaseMaterial3D::TextureFilter::
-                                        TEXTURE_FILTER_NEAREST_WITH_MIPMAPS );
-                                break;
-                            case Sampler::MinFilter::LINEAR:
-                                material->set_texture_filter(
-                                    BaseMaterial3D::TextureFilter::TEXTURE_FILTER_LINEAR );
-                                break;
-                            case Sampler::MinFilter::LINEAR_MIPMAP_NEAREST:
-                                material->set_texture_filter(
-                                    BaseMaterial3D::TextureFilter::
-                                        TEXTURE_FILTER_LINEAR_WITH_MIPMAPS );
-                                break;
-                            default:
-                                material->set_texture_filter(
-                                    BaseMaterial3D::TextureFilter::TEXTURE_FILTER_MAX );
-                        }
-                    }
-                }
-            }
+            key.textureFilter = getTextureFilter( *pSampler );
         }
     }
+    key.metallicTexture =
+        resolveTexture( loadTexture, primitiveInfo, pbr.metallicRoughnessTexture );
+    key.emissionTexture =
+        resolveTexture( loadTexture, primitiveInfo, gltfMaterial.emissiveTexture );
+    key.normalTexture = resolveTexture( loadTexture, primitiveInfo, gltfMaterial.normalTexture );
+    key.occlusionTexture =
+        resolveTexture( loadTexture, primitiveInfo, gltfMaterial.occlusionTexture );
 
-    const std::optional<TextureInfo> &metallicRoughness = pbr.metallicRoughnessTexture;
-    if ( metallicRoughness )
-    {
-        auto texCoordIndexIt = primitiveInfo.uvIndexMap.find( metallicRoughness->texCoord );
-        if ( texCoordIndexIt != primitiveInfo.uvIndexMap.end() )
-        {
-            Ref<godot::Texture> gTexture = loadTexture( model, metallicRoughness->index, false );
-            if ( gTexture.is_valid() )
-            {
-                material->set_texture( StandardMaterial3D::TextureParam::TEXTURE_METALLIC,
-                                       gTexture );
-            }
-        }
-    }
+    // Handle KHR_texture_transform for each available texture.
+    resolveTextureTransform( pbr.baseColorTexture, key );
+    resolveTextureTransform( pbr.metallicRoughnessTexture, key );
+    resolveTextureTransform( gltfMaterial.normalTexture, key );
+    resolveTextureTransform( gltfMaterial.emissiveTexture, key );
+    resolveTextureTransform( gltfMaterial.occlusionTexture, key );
 
-    const std::vector<double> &emissiveFactor = gltfMaterial.emissiveFactor;
-    if ( gltfMaterial.emissiveTexture )
-    {
-        auto texCoordIndexIt =
-            primitiveInfo.uvIndexMap.find( gltfMaterial.emissiveTexture->texCoord );
-        if ( texCoordIndexIt != primitiveInfo.uvIndexMap.end() )
-        {
-            Ref<godot::Texture> gTexture =
-                loadTexture( model, gltfMaterial.emissiveTexture->index, true );
-            if ( gTexture.is_valid() )
-            {
-                material->set_texture( StandardMaterial3D::TextureParam::TEXTURE_EMISSION,
-                                       gTexture );
-            }
-        }
-    }
+    return key;
+}
 
-    if ( gltfMaterial.normalTexture )
+Ref<StandardMaterial3D> createMaterial( const MaterialKey &key )
+{
+    Ref<StandardMaterial3D> material;
+    material.instantiate();
+    if ( !key.hasGltfMaterial )
     {
-        auto texCoordIndexIt =
-            primitiveInfo.uvIndexMap.find( gltfMaterial.normalTexture->texCoord );
-        if ( texCoordIndexIt != primitiveInfo.uvIndexMap.end() )
-        {
-            Ref<godot::Texture> gTexture =
-                loadTexture( model, gltfMaterial.normalTexture->index, true );
-            if ( gTexture.is_valid() )
-            {
-                material->set_texture( StandardMaterial3D::TextureParam::TEXTURE_NORMAL, gTexture );
-            }
-        }
+        return material;
     }
 
-    if ( gltfMaterial.occlusionTexture )
+    material->set_albedo( key.albedo );
+    material->set_metallic( key.metallic );
+    material->set_roughness( key.roughness );
+    if ( key.unlit )
     {
-        auto texCoordIndexIt =
-            primitiveInfo.uvIndexMap.find( gltfMaterial.occlusionTexture->texCoord );
-        if ( texCoordIndexIt != primitiveInfo.uvIndexMap.end() )
-        {
-            Ref<godot::Texture> gTexture =
-                loadTexture( model, gltfMaterial.occlusionTexture->index, true );
-            if ( gTexture.is_valid() )
-            {
-                material->set_texture( StandardMaterial3D::TextureParam::TEXTURE_AMBIENT_OCCLUSION,
-                                       gTexture );
-            }
-        }
+        material->set_shading_mode( BaseMaterial3D::SHADING_MODE_UNSHADED );
     }
-
-    // Handle KHR_texture_transform for each available texture.
-    CesiumGltf::KhrTextureTransform textureTransform;
-    const CesiumGltf::ExtensionKhrTextureTransform *pBaseColorTextureTransform =
-        pbr.baseColorTexture
-            ? pbr.baseColorTexture->getExtension<CesiumGltf::ExtensionKhrTextureTransform>()
-            : nullptr;
-    if ( pBaseColorTextureTransform )
-    {
-        textureTransform = CesiumGltf::KhrTextureTransform( *pBaseColorTextureTransform );
-        if ( textureTransform.status() == CesiumGltf::KhrTextureTransformStatus::Valid )
-        {
-            const glm::dvec2 &scale = textureTransform.scale();
-            const glm::dvec2 &offset = textureTransform.offset();
-            material->set_uv1_scale( Vector3( scale[0], scale[1], 0 ) );
-            material->set_uv1_offset( Vector3( offset[0], offset[1], 0 ) );
-        }
+    if ( key.albedoTexture.is_valid() )
+    {
+        material->set_texture( BaseMaterial3D::TEXTURE_ALBEDO, key.albedoTexture );
+        material->set_texture_filter( key.textureFilter );
     }
-
-    const CesiumGltf::ExtensionKhrTextureTransform *pMetallicRoughnessTextureTransform =
-        pbr.metallicRoughnessTexture
-            ? pbr.metallicRoughnessTexture->getExtension<CesiumGltf::ExtensionKhrTextureTransform>()
-            : nullptr;
-    if ( pMetallicRoughnessTextureTransform )
+    if ( key.metallicTexture.is_valid() )
     {
-        textureTransform = CesiumGltf::KhrTextureTransform( *pMetallicRoughnessTextureTransform );
-        if ( textureTransform.status() == CesiumGltf::KhrTextureTransformStatus::Valid )
-        {
-            const glm::dvec2 &scale = textureTransform.scale();
-            const glm::dvec2 &offset = textureTransform.offset();
-            material->set_uv1_scale( Vector3( scale[0], scale[1], 0 ) );
-            material->set_uv1_offset( Vector3( offset[0], offset[1], 0 ) );
-        }
+        material->set_texture( BaseMaterial3D::TEXTURE_METALLIC, key.metallicTexture );
     }
-
-    const CesiumGltf::ExtensionKhrTextureTransform *pNormalTextureTransform =
-        gltfMaterial.normalTexture
-            ? gltfMaterial.normalTexture->getExtension<CesiumGltf::ExtensionKhrTextureTransform>()
-            : nullptr;
-    if ( pNormalTextureTransform )
+    if ( key.emissionTexture.is_valid() )
     {
-        textureTransform = CesiumGltf::KhrTextureTransform( *pNormalTextureTransform );
-        if ( textureTransform.status() == CesiumGltf::KhrTextureTransformStatus::Valid )
-        {
-            const glm::dvec2 &scale = textureTransform.scale();
-            const glm::dvec2 &offset = textureTransform.offset();
-            material->set_uv1_scale( Vector3( scale[0], scale[1], 0 ) );
-            material->set_uv1_offset( Vector3( offset[0], offset[1], 0 ) );
-        }
+        material->set_texture( BaseMaterial3D::TEXTURE_EMISSION, key.emissionTexture );
     }
-
-    const CesiumGltf::ExtensionKhrTextureTransform *pEmissiveTextureTransform =
-        gltfMaterial.emissiveTexture
-            ? gltfMaterial.emissiveTexture->getExtension<CesiumGltf::ExtensionKhrTextureTransform>()
-            : nullptr;
-    if ( pEmissiveTextureTransform )
+    if ( key.normalTexture.is_valid() )
     {
-        textureTransform = CesiumGltf::KhrTextureTransform( *pEmissiveTextureTransform );
-        if ( textureTransform.status() == CesiumGltf::KhrTextureTransformStatus::Valid )
-        {
-            const glm::dvec2 &scale = textureTransform.scale();
-            const glm::dvec2 &offset = textureTransform.offset();
-            material->set_uv1_scale( Vector3( scale[0], scale[1], 0 ) );
-            material->set_uv1_offset( Vector3( offset[0], offset[1], 0 ) );
-        }
+        material->set_texture( BaseMaterial3D::TEXTURE_NORMAL, key.normalTexture );
     }
-
-    const CesiumGltf::ExtensionKhrTextureTransform *pOcclusionTextureTransform =
-        gltfMaterial.occlusionTexture
-            ? gltfMaterial.occlusionTexture
-                  ->getExtension<CesiumGltf::ExtensionKhrTextureTransform>()
-            : nullptr;
-    if ( pOcclusionTextureTransform )
+    if ( key.occlusionTexture.is_valid() )
     {
-        textureTransform = CesiumGltf::KhrTextureTransform( *pOcclusionTextureTransform );
-        if ( textureTransform.status() == CesiumGltf::KhrTextureTransformStatus::Valid )
-        {
-            const glm::dvec2 &scale = textureTransform.scale();
-            const glm::dvec2 &offset = textureTransform.offset();
-            material->set_uv1_scale( Vector3( scale[0], scale[1], 0 ) );
-            material->set_uv1_offset( Vector3( offset[0], offset[1], 0 ) );
-        }
+        material->set_texture( BaseMaterial3D::TEXTURE_AMBIENT_OCCLUSION, key.occlusionTexture );
     }
+    material->set_uv1_scale( key.uv1Scale );
+    material->set_uv1_offset( key.uv1Offset );
+    return material;
 }
 
-void extractVertexData( const std::vector<uint8_t> &vertexData,
-                        const VertexAttributeDescriptor *descriptors,
-                        const int32_t numberOfAttributes, std::vector<glm::vec3> &positions,
-                        std::vector<glm::vec3> &normals, std::vector<uint32_t> &colors,
-                        std::vector<glm::vec2> &uvs )
+// Octahedral encoding as used by Godot for compressed normals, mapped to [0, 1].
+glm::vec2 octahedronEncode( glm::vec3 n )
 {
-    size_t stride = 0;
-    for ( int32_t i = 0; i < numberOfAttributes; ++i )
+    n /= std::abs( n.x ) + std::abs( n.y ) + std::abs( n.z );
+    glm::vec2 o( n.x, n.y );
+    if ( n.z < 0.0f )
     {
-        const VertexAttributeDescriptor &desc = descriptors[i];
-        size_t attributeSize = 0;
-        switch ( desc.format )
-        {
-            case VertexAttributeFormat::Float32:
-            case VertexAttributeFormat::UInt32:
-            case VertexAttributeFormat::SInt32:
-                attributeSize = sizeof( float ) * desc.dimension;
-                break;
-            case VertexAttributeFormat::Float16:
-            case VertexAttributeFormat::UNorm16:
-            case VertexAttributeFormat::SNorm16:
-            case VertexAttributeFormat::UInt16:
-            case VertexAttributeFormat::SInt16:
-                attributeSize = sizeof( uint16_t ) * desc.dimension;
-                break;
-            case VertexAttributeFormat::UNorm8:
-            case VertexAttributeFormat::SNorm8:
-            case VertexAttributeFormat::UInt8:
-            case VertexAttributeFormat::SInt8:
-                attributeSize = sizeof( uint8_t ) * desc.dimension;
-                break;
-            default:
-                break;
-        }
-        stride += attributeSize;
+        o.x = ( 1.0f - std::abs( n.y ) ) * ( n.x >= 0.0f ? 1.0f : -1.0f );
+        o.y = ( 1.0f - std::abs( n.x ) ) * ( n.y >= 0.0f ? 1.0f : -1.0f );
     }
+    return o * 0.5f + 0.5f;
+}
+
+uint16_t packUNorm16( float value )
+{
+    return static_cast<uint16_t>( std::clamp( value * 65535.0f, 0.0f, 65535.0f ) );
+}
 
-    const uint8_t *pData = vertexData.data();
-    size_t vertexCount = vertexData.size() / stride;
-    positions.resize( vertexCount );
-    colors.resize( vertexCount, 0xFFFFFFFF ); // set white color default if no colors
-    normals.resize( vertexCount );
-    uvs.resize( vertexCount );
-    for ( size_t i = 0; i < vertexCount; ++i )
+/**
+ * Packs a normal and a tangent (w = bitangent sign) into Godot's compressed normal/tangent
+ * vertex attribute: two octahedral-encoded vectors of 2 x uint16 each.
+ */
+void packNormalTangent( const glm::vec3 &normal, const glm::vec4 &tangent, uint8_t *pTarget )
+{
+    glm::vec2 n = octahedronEncode( normal );
+    glm::vec2 t = octahedronEncode( glm::vec3( tangent ) );
+    // The tangent's second component also carries the bitangent sign.
+    t.y = std::max( t.y, 1.0f / 32767.0f ) * 0.5f + 0.5f;
+    if ( tangent.w < 0.0f )
     {
-        const uint8_t *pVertex = pData + i * stride;
-        for ( int32_t j = 0; j < numberOfAttributes; ++j )
-        {
-            const VertexAttributeDescriptor &desc = descriptors[j];
-            switch ( desc.attribute )
-            {
-                case VertexAttribute::Position:
-                {
-                    assert( desc.format == VertexAttributeFormat::Float32 && desc.dimension == 3 );
-                    glm::vec3 pos;
-                    std::memcpy( &pos, pVertex, sizeof( pos ) );
-                    positions[i] = pos;
-                    pVertex += sizeof( pos );
-                    break;
-                }
-                case VertexAttribute::Normal:
-                {
-                    assert( desc.format == VertexAttributeFormat::Float32 && desc.dimension == 3 );
-                    glm::vec3 norm;
-                    std::memcpy( &norm, pVertex, sizeof( norm ) );
-                    normals[i] = norm;
-                    pVertex += sizeof( norm );
-                    break;
-                }
-                case VertexAttribute::Color:
-                {
-                    assert( desc.format == VertexAttributeFormat::UNorm8 && desc.dimension == 4 );
-                    uint32_t color;
-                    std::memcpy( &color, pVertex, sizeof( color ) );
-                    colors[i] = color;
-                    pVertex += sizeof( color );
-                    break;
-                }
-                case VertexAttribute::TexCoord0:
-                {
-                    assert( desc.format == VertexAttributeFormat::Float32 && desc.dimension == 2 );
-                    glm::vec2 uv;
-                    std::memcpy( &uv, pVertex, sizeof( uv ) );
-                    uvs[i] = uv;
-                    pVertex += sizeof( uv );
-                    break;
-                }
-                default:
-                    break;
-            }
-        }
+        t.y = 1.0f - t.y;
     }
+
+    uint16_t packed[4] = { packUNorm16( n.x ), packUNorm16( n.y ), packUNorm16( t.x ),
+                           packUNorm16( t.y ) };
+    std::memcpy( pTarget, packed, sizeof( packed ) );
+}
+
+glm::vec3 normalizeOr( const glm::vec3 &v, const glm::vec3 &fallback )
+{
+    float length = glm::length( v );
+    return length > 1e-12f ? v / length : fallback;
+}
+
+// Any unit tangent perpendicular to the normal, for primitives without a TANGENT attribute.
+glm::vec4 tangentFromNormal( const glm::vec3 &normal )
+{
+    glm::vec3 axis = std::abs( normal.y ) < 0.99f ? glm::vec3( 0, 1, 0 ) : glm::vec3( 1, 0, 0 );
+    return glm::vec4( glm::normalize( glm::cross( axis, normal ) ), 1.0f );
 }
 
 template <typename TIndex, class TIndexAccessor>
-void loadPrimitive( Ref<ArrayMesh> arrMesh, CesiumPrimitiveInfo &primitiveInfo,
+void loadPrimitive( Dictionary &surface, CesiumPrimitiveInfo &primitiveInfo,
                     const CesiumGltf::Model &gltf, const CesiumGltf::Node &node,
                     const CesiumGltf::Mesh &mesh, const MeshPrimitive &primitive,
                     const glm::dmat4 &transform, const TIndexAccessor &indicesView,
@@ -773,15 +779,21 @@ void loadPrimitive( Ref<ArrayMesh> arrMesh, CesiumPrimitiveInfo &primitiveInfo,
             return;
     }
 
-    if ( indexCount < 3 && primitive.mode != MeshPrimitive::Mode::POINTS )
+    if ( primitive.mode != MeshPrimitive::Mode::POINTS )
     {
-        return;
+        // Drop a trailing partial triangle.
+        indexCount -= indexCount % 3;
+        if ( indexCount < 3 )
+        {
+            return;
+        }
     }
 
     const CesiumGltf::Material *pMaterial =
         CesiumGltf::Model::getSafe( &gltf.materials, primitive.material );
 
     primitiveInfo.isUnlit = pMaterial && pMaterial->hasExtension<ExtensionKhrMaterialsUnlit>();
+    primitiveInfo.containsPoints = primitive.mode == MeshPrimitive::Mode::POINTS;
 
     bool hasNormals = false;
     bool shouldComputeFlatNormals = false;
@@ -789,8 +801,14 @@ void loadPrimitive( Ref<ArrayMesh> arrMesh, CesiumPrimitiveInfo &primitiveInfo,
     AccessorView<glm::vec3> normalView;
     if ( normalAccessorIt != primitive.attributes.end() )
     {
+        // Normals are read per position, so a short accessor would throw partway through.
         normalView = AccessorView<glm::vec3>( gltf, normalAccessorIt->second );
-        hasNormals = normalView.status() == AccessorViewStatus::Valid;
+        hasNormals = normalView.status() == AccessorViewStatus::Valid &&
+                     normalView.size() >= positionView.size();
+        if ( !hasNormals )
+        {
+            SPDLOG_WARN( "Ignoring normal buffer that is invalid or shorter than the positions." );
+        }
     }
     else if ( !primitiveInfo.isUnlit && primitive.mode != MeshPrimitive::Mode::POINTS )
     {
@@ -798,105 +816,100 @@ void loadPrimitive( Ref<ArrayMesh> arrMesh, CesiumPrimitiveInfo &primitiveInfo,
         SPDLOG_INFO( "Invalid normal buffer. Flat normals will be auto-generated instead." );
     }
 
-    // Check if  we need to upgrade to a large index type to accommodate the
-    // larger number of vertices we need for flat normals.
-    if ( shouldComputeFlatNormals && indexFormat == IndexFormat::UInt16 &&
-         indexCount >= std::numeric_limits<uint16_t>::max() )
+    int32_t vertexCount =
+        shouldComputeFlatNormals ? indexCount : static_cast<int32_t>( positionView.size() );
+
+    // Godot reads index_data as uint16 exactly when the surface has at most
+    // maximumShortIndexVertexCount vertices. Flat normals give every corner its own vertex, so
+    // the final vertex count, and with it the index width, can end up above or below the one
+    // the caller picked from the positions.
+    const bool shortIndices = vertexCount <= maximumShortIndexVertexCount;
+    if ( shortIndices != ( indexFormat == IndexFormat::UInt16 ) )
     {
-        loadPrimitive<uint32_t>( arrMesh, primitiveInfo, gltf, node, mesh, primitive, transform,
-                                 indicesView, IndexFormat::UInt32, positionView );
+        if ( shortIndices )
+        {
+            loadPrimitive<uint16_t>( surface, primitiveInfo, gltf, node, mesh, primitive,
+                                     transform, indicesView, IndexFormat::UInt16, positionView );
+        }
+        else
+        {
+            loadPrimitive<uint32_t>( surface, primitiveInfo, gltf, node, mesh, primitive,
+                                     transform, indicesView, IndexFormat::UInt32, positionView );
+        }
         return;
     }
 
-    std::vector<TIndex> indices;
-    indices.resize( indexCount );
-    TIndex *indicesData = indices.data();
-
-    switch ( primitive.mode )
-    {
-        case MeshPrimitive::Mode::TRIANGLES:
-        case MeshPrimitive::Mode::POINTS:
-            for ( int32_t i = 0; i < indicesView.size(); ++i )
-            {
-                indicesData[i] = indicesView[i];
-            }
-            break;
-        case MeshPrimitive::Mode::TRIANGLE_STRIP:
-            for ( int32_t i = 0; i < indicesView.size() - 2; ++i )
+    // Maps corner i of the output triangle list to a vertex index of the glTF primitive.
+    auto sourceIndex = [&indicesView, mode = primitive.mode]( int32_t corner ) -> int64_t {
+        switch ( mode )
+        {
+            case MeshPrimitive::Mode::TRIANGLE_STRIP:
             {
-                if ( i % 2 )
-                {
-                    indicesData[3 * i] = indicesView[i];
-                    indicesData[3 * i + 1] = indicesView[i + 2];
-                    indicesData[3 * i + 2] = indicesView[i + 1];
-                }
-                else
+                int32_t triangle = corner / 3;
+                int32_t vertex = corner % 3;
+                // Every other triangle of a strip has its winding reversed.
+                if ( triangle % 2 && vertex )
                 {
-                    indicesData[3 * i] = indicesView[i];
-                    indicesData[3 * i + 1] = indicesView[i + 1];
-                    indicesData[3 * i + 2] = indicesView[i + 2];
+                    vertex = 3 - vertex;
                 }
+                return static_cast<int64_t>( indicesView[triangle + vertex] );
             }
-            break;
-        case CesiumGltf::MeshPrimitive::Mode::TRIANGLE_FAN:
-        default:
-            for ( int32_t i = 2; i < indicesView.size(); ++i )
+            case MeshPrimitive::Mode::TRIANGLE_FAN:
             {
-                indicesData[3 * i] = indicesView[0];
-                indicesData[3 * i + 1] = indicesView[i - 1];
-                indicesData[3 * i + 2] = indicesView[i];
+                int32_t vertex = corner % 3;
+                return static_cast<int64_t>( vertex ? indicesView[corner / 3 + vertex]
+                                                    : indicesView[0] );
             }
-            break;
-    }
-
-    const int32_t MAX_ATTRIBUTES = 14;
-    VertexAttributeDescriptor descriptors[MAX_ATTRIBUTES];
-
-    // Interleave all attributes into single stream.
-    int32_t numberOfAttributes = 0;
-
-    descriptors[numberOfAttributes].attribute = VertexAttribute::Position;
-    descriptors[numberOfAttributes].format = VertexAttributeFormat::Float32;
-    descriptors[numberOfAttributes].dimension = 3;
-    ++numberOfAttributes;
+            default:
+                return static_cast<int64_t>( indicesView[corner] );
+        }
+    };
 
-    if ( hasNormals )
+    // Indices are copied straight into the surface, so an out-of-range index of a malformed or
+    // truncated tile would reach the GPU. Such primitives are skipped. This is checked before
+    // narrowing to TIndex, which could wrap an index back into range.
+    const int64_t sourceVertexCount = positionView.size();
+    for ( int32_t i = 0; i < indexCount; ++i )
     {
-        assert( numberOfAttributes < MAX_ATTRIBUTES );
-        descriptors[numberOfAttributes].attribute = VertexAttribute::Normal;
-        descriptors[numberOfAttributes].format = VertexAttributeFormat::Float32;
-        descriptors[numberOfAttributes].dimension = 3;
-        ++numberOfAttributes;
+        const int64_t index = sourceIndex( i );
+        if ( index < 0 || index >= sourceVertexCount )
+        {
+            SPDLOG_WARN( "Skipping primitive with vertex index {} out of range; it has {} "
+                         "vertices.",
+                         index, sourceVertexCount );
+            return;
+        }
     }
 
-    bool needsTangents = hasNormals;
+    // Note: Godot uses clockwise winding order for front faces of triangle primitive modes, so
+    // the first and last corner of every triangle are swapped while writing the indices.
+    const bool flipWinding = primitive.mode != MeshPrimitive::Mode::POINTS;
+    auto targetCorner = [flipWinding]( int32_t corner ) {
+        return flipWinding ? corner + 2 - 2 * ( corner % 3 ) : corner;
+    };
+
     bool hasTangents = false;
+    AccessorView<glm::vec4> tangentView;
     auto tangentAccessorIt = primitive.attributes.find( "TANGENT" );
-    if ( tangentAccessorIt != primitive.attributes.end() )
+    if ( hasNormals && !shouldComputeFlatNormals &&
+         tangentAccessorIt != primitive.attributes.end() )
     {
-        int32_t tangentAccessorID = tangentAccessorIt->second;
-        auto tangentAccessor = AccessorView<glm::vec4>( gltf, tangentAccessorID );
-        hasTangents = tangentAccessor.status() == AccessorViewStatus::Valid;
+        tangentView = AccessorView<glm::vec4>( gltf, tangentAccessorIt->second );
+        hasTangents = tangentView.status() == AccessorViewStatus::Valid &&
+                      tangentView.size() >= positionView.size();
         if ( !hasTangents )
         {
             SPDLOG_INFO( "Invalid tangent buffer." );
         }
     }
 
-    // Add the COLOR_0 attribute, if it exists.
+    // COLOR_0 isn't uploaded, but translucent vertex colors still affect the material.
     auto colorAccessorIt = primitive.attributes.find( "COLOR_0" );
     bool hasVertexColors =
         colorAccessorIt != primitive.attributes.end() &&
         validateVertexColors( gltf, colorAccessorIt->second, positionView.size() );
     if ( hasVertexColors )
     {
-        assert( numberOfAttributes < MAX_ATTRIBUTES );
-
-        descriptors[numberOfAttributes].attribute = VertexAttribute::Color;
-        descriptors[numberOfAttributes].format = VertexAttributeFormat::UNorm8;
-        descriptors[numberOfAttributes].dimension = 4;
-        ++numberOfAttributes;
-
         const int8_t numComponents =
             gltf.accessors[colorAccessorIt->second].computeNumberOfComponents();
         if ( numComponents == 4 )
@@ -919,24 +932,15 @@ void loadPrimitive( Ref<ArrayMesh> arrMesh, CesiumPrimitiveInfo &primitiveInfo,
             continue;
         }
         AccessorView<glm::vec2> texCoordView( gltf, texCoordAccessorIt->second );
-        if ( texCoordView.status() != AccessorViewStatus::Valid &&
-             texCoordView.size() >= positionView.size() )
+        if ( texCoordView.status() != AccessorViewStatus::Valid ||
+             texCoordView.size() < positionView.size() )
         {
             continue;
         }
 
         texCoordViews[numTexCoords] = texCoordView;
         primitiveInfo.uvIndexMap[i] = numTexCoords;
-
-        assert( numberOfAttributes < MAX_ATTRIBUTES );
-
-        descriptors[numberOfAttributes].attribute =
-            (VertexAttribute)( (int)VertexAttribute::TexCoord0 + numTexCoords );
-        descriptors[numberOfAttributes].format = VertexAttributeFormat::Float32;
-        descriptors[numberOfAttributes].dimension = 2;
-
         ++numTexCoords;
-        ++numberOfAttributes;
     }
 
     // Add all texture coordinate sets _CESIUMOVERLAY_i
@@ -951,198 +955,136 @@ void loadPrimitive( Ref<ArrayMesh> arrMesh, CesiumPrimitiveInfo &primitiveInfo,
         }
 
         AccessorView<glm::vec2> overlayTexCoordView( gltf, overlayAccessorIt->second );
-        if ( overlayTexCoordView.status() != AccessorViewStatus::Valid &&
-             overlayTexCoordView.size() >= positionView.size() )
+        if ( overlayTexCoordView.status() != AccessorViewStatus::Valid ||
+             overlayTexCoordView.size() < positionView.size() )
         {
             continue;
         }
 
         texCoordViews[numTexCoords] = overlayTexCoordView;
         primitiveInfo.rasterOverlayUvIndexMap[i] = numTexCoords;
-
-        assert( numberOfAttributes < MAX_ATTRIBUTES );
-        descriptors[numberOfAttributes].attribute =
-            (VertexAttribute)( (int)VertexAttribute::TexCoord0 + numTexCoords );
-        descriptors[numberOfAttributes].format = VertexAttributeFormat::Float32;
-        descriptors[numberOfAttributes].dimension = 2;
-
         ++numTexCoords;
-        ++numberOfAttributes;
     }
 
-    int32_t vertexCount =
-        shouldComputeFlatNormals ? indexCount : static_cast<int32_t>( positionView.size() );
-    std::vector<uint8_t> vertexData;
-    vertexData.resize( computeVertexDataSize( vertexCount, descriptors, numberOfAttributes ) );
-    uint8_t *pBufferStart = vertexData.data();
-    uint8_t *pWritePos = pBufferStart;
-
-    // Since the vertex buffer is dynamically interleaved, we don't have a
-    // convenient struct to represent the vertex data.
-    // The vertex layout will be as follows:
-    // 1. position
-    // 2. normals (skip if N/A)
-    // 3. vertex colors (skip if N/A)
-    // 4. texcoords (first all TEXCOORD_i, then all _CESIUMOVERLAY_i)
-    size_t stride = sizeof( glm::vec3 );
-    size_t normalByteOffset, colorByteOffset;
-    if ( hasNormals )
-    {
-        normalByteOffset = stride;
-        stride += sizeof( glm::vec3 );
-    }
+    // The surface is built directly in Godot's native vertex format, so the engine can upload
+    // it as is instead of validating and re-packing a surface array:
+    //   vertex_data:    positions (float3) of all vertices, followed by the normal/tangent
+    //                   pairs (see packNormalTangent) of all vertices
+    //   attribute_data: UV (float2) per vertex
+    //   index_data:     TIndex per corner
+    const size_t positionSize = sizeof( glm::vec3 );
+    const size_t normalTangentSize = hasNormals ? 4 * sizeof( uint16_t ) : 0;
+    const size_t uvSize = numTexCoords > 0 ? sizeof( glm::vec2 ) : 0;
 
-    if ( hasVertexColors )
-    {
-        colorByteOffset = stride;
-        stride += sizeof( uint32_t );
-    }
-    stride += numTexCoords * sizeof( glm::vec2 );
+    PackedByteArray vertexData;
+    vertexData.resize( vertexCount * ( positionSize + normalTangentSize ) );
+    uint8_t *pPositions = vertexData.ptrw();
+    uint8_t *pNormalTangents = pPositions + vertexCount * positionSize;
 
-    if ( shouldComputeFlatNormals )
-    {
-        computeFlatNormals( pWritePos + normalByteOffset, stride, indicesData, indexCount,
-                            positionView );
-        for ( int64_t i = 0; i < vertexCount; ++i )
-        {
-            TIndex vertexIndex = indicesData[i];
-            *reinterpret_cast<glm::vec3 *>( pWritePos ) = positionView[vertexIndex];
-            //   skip position and normal
-            pWritePos += 2 * sizeof( glm::vec3 );
-            // Skip the slot allocated for vertex colors, we will fill them in
-            //  bulk later.
-            if ( hasVertexColors )
-            {
-                pWritePos += sizeof( uint32_t );
-            }
-            for ( uint32_t texCoordIndex = 0; texCoordIndex < numTexCoords; ++texCoordIndex )
-            {
-                *reinterpret_cast<glm::vec2 *>( pWritePos ) =
-                    texCoordViews[texCoordIndex][vertexIndex];
-                pWritePos += sizeof( glm::vec2 );
-            }
-        }
-    }
-    else
-    {
-        for ( int64_t i = 0; i < vertexCount; ++i )
-        {
-            *reinterpret_cast<glm::vec3 *>( pWritePos ) = positionView[i];
-            pWritePos += sizeof( glm::vec3 );
+    PackedByteArray attributeData;
+    attributeData.resize( vertexCount * uvSize );
+    uint8_t *pUvs = attributeData.ptrw();
 
-            if ( hasNormals )
-            {
-                *reinterpret_cast<glm::vec3 *>( pWritePos ) = normalView[i];
-                pWritePos += sizeof( glm::vec3 );
-            }
+    PackedByteArray indexData;
+    indexData.resize( indexCount * sizeof( TIndex ) );
+    TIndex *pIndices = reinterpret_cast<TIndex *>( indexData.ptrw() );
 
-            // Skip the slot allocated for vertex colors, we will fill them in
-            // bulk later.
-            if ( hasVertexColors )
-            {
-                pWritePos += sizeof( uint32_t );
-            }
+    glm::vec3 minimum( std::numeric_limits<float>::max() );
+    glm::vec3 maximum( std::numeric_limits<float>::lowest() );
 
-            for ( uint32_t texCoordIndex = 0; texCoordIndex < numTexCoords; ++texCoordIndex )
-            {
-                *reinterpret_cast<glm::vec2 *>( pWritePos ) = texCoordViews[texCoordIndex][i];
-                pWritePos += sizeof( glm::vec2 );
-            }
-        }
-    }
+    auto writeVertex = [&]( int32_t target, int64_t source, const glm::vec3 &normal ) {
+        const glm::vec3 &position = positionView[source];
+        std::memcpy( pPositions + target * positionSize, &position, positionSize );
+        minimum = glm::min( minimum, position );
+        maximum = glm::max( maximum, position );
 
-    // Fill in vertex colors separately, createAccessorView if they exist.
-    if ( hasVertexColors )
-    {
-        // Color comes after position and normal
-        createAccessorView( gltf, colorAccessorIt->second,
-                            CopyVertexColors<TIndex>{ pBufferStart + colorByteOffset, stride,
-                                                      static_cast<size_t>( vertexCount ),
-                                                      shouldComputeFlatNormals, indicesData } );
-    }
+        if ( hasNormals )
+        {
+            glm::vec3 n = normalizeOr( normal, glm::vec3( 0, 0, 1 ) );
+            glm::vec4 tangent = hasTangents ? tangentView[source] : tangentFromNormal( n );
+            packNormalTangent( n, tangent, pNormalTangents + target * normalTangentSize );
+        }
+        if ( uvSize )
+        {
+            const glm::vec2 &uv = texCoordViews[0][source];
+            std::memcpy( pUvs + target * uvSize, &uv, uvSize );
+        }
+    };
 
     if ( shouldComputeFlatNormals )
     {
-        // rewrite indices
-        for ( int32_t i = 0; i < indexCount; ++i )
+        // Every corner gets its own vertex so each triangle can carry its face normal.
+        for ( int32_t i = 0; i < indexCount; i += 3 )
         {
-            indicesData[i] = i;
+            const int64_t v0 = sourceIndex( i );
+            const int64_t v1 = sourceIndex( i + 1 );
+            const int64_t v2 = sourceIndex( i + 2 );
+            const glm::vec3 &p0 = positionView[v0];
+            glm::vec3 normal = glm::cross( positionView[v1] - p0, positionView[v2] - p0 );
+            writeVertex( i, v0, normal );
+            writeVertex( i + 1, v1, normal );
+            writeVertex( i + 2, v2, normal );
         }
     }
-
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> normals;
-    std::vector<uint32_t> colors;
-    std::vector<glm::vec2> uvs;
-    extractVertexData( vertexData, descriptors, numberOfAttributes, positions, normals, colors,
-                       uvs );
-
-    //----------------------------------------------------------------------------
-    PackedInt32Array indices_;
-    PackedVector3Array verts_;
-    PackedVector2Array uvs_;
-    PackedVector3Array normals_;
-
-    indices_.resize( indices.size() );
-    for ( size_t i = 0, len = indices.size(); i < len; ++i )
+    else
     {
-        indices_.set( i, static_cast<uint64_t>( indices[i] ) );
+        for ( int32_t i = 0; i < vertexCount; ++i )
+        {
+            writeVertex( i, i, hasNormals ? normalView[i] : glm::vec3( 0.0f ) );
+        }
     }
-    // Note: Godot uses clockwise winding order for front faces of triangle primitive modes.
-    // need to reverse indices or it won't render correctly.
-    indices_.reverse();
 
-    verts_.resize( positions.size() );
-    size_t i = 0;
-    for ( glm::vec3 &vec3 : positions )
+    for ( int32_t i = 0; i < indexCount; ++i )
     {
-        verts_.set( i, Vector3( vec3.x, vec3.y, vec3.z ) );
-        ++i;
+        pIndices[targetCorner( i )] =
+            static_cast<TIndex>( shouldComputeFlatNormals ? i : sourceIndex( i ) );
     }
 
-    normals_.resize( normals.size() );
-    i = 0;
-    for ( glm::vec3 &vec3 : normals )
+    uint64_t format = RenderingServer::ARRAY_FORMAT_VERTEX | RenderingServer::ARRAY_FORMAT_INDEX |
+                      RenderingServer::ARRAY_FLAG_FORMAT_CURRENT_VERSION;
+    if ( hasNormals )
     {
-        normals_.set( i, Vector3( vec3.x, vec3.y, vec3.z ) );
-        ++i;
+        format |= RenderingServer::ARRAY_FORMAT_NORMAL | RenderingServer::ARRAY_FORMAT_TANGENT;
     }
-
-    uvs_.resize( uvs.size() );
-    i = 0;
-    for ( glm::vec2 &vec2 : uvs )
+    if ( uvSize )
     {
-        uvs_.set( i, Vector2( vec2.x, vec2.y ) );
-        ++i;
+        format |= RenderingServer::ARRAY_FORMAT_TEX_UV;
     }
 
-    Array surface_array;
-    surface_array.resize( ArrayMesh::ARRAY_MAX );
-    surface_array[ArrayMesh::ARRAY_VERTEX] = verts_;
-    surface_array[ArrayMesh::ARRAY_INDEX] = indices_;
-    if ( hasNormals || shouldComputeFlatNormals )
-    {
-        surface_array[ArrayMesh::ARRAY_NORMAL] = normals_;
-    }
-    surface_array[ArrayMesh::ARRAY_TEX_UV] = uvs_;
-    arrMesh->add_surface_from_arrays( ArrayMesh::PRIMITIVE_TRIANGLES, surface_array );
+    surface["format"] = format;
+    surface["primitive"] = primitive.mode == MeshPrimitive::Mode::POINTS
+                               ? RenderingServer::PRIMITIVE_POINTS
+                               : RenderingServer::PRIMITIVE_TRIANGLES;
+    surface["vertex_data"] = vertexData;
+    surface["attribute_data"] = attributeData;
+    surface["vertex_count"] = vertexCount;
+    surface["index_data"] = indexData;
+    surface["index_count"] = indexCount;
+    surface["aabb"] = AABB( Vector3( minimum.x, minimum.y, minimum.z ),
+                            Vector3( maximum.x - minimum.x, maximum.y - minimum.y,
+                                     maximum.z - minimum.z ) );
 }
 
-void populateMeshDataArray( std::vector<Ref<ArrayMesh>> &aMeshes,
-                            std::vector<CesiumPrimitiveInfo> &primitiveInfos,
-                            CesiumGltf::Model *pModel )
+/**
+ * Builds one ArrayMesh for the whole model, with one surface per primitive that has geometry.
+ * primitiveInfos gets an entry for every primitive, in forEachPrimitiveInScene order. The
+ * triangles of all surfaces are also appended to pCollisionFaces, if given.
+ */
+void populateMesh( Ref<ArrayMesh> &aMesh,
+                   std::vector<CesiumPrimitiveInfo> &primitiveInfos,
+                   DecodedImages &images,
+                   CesiumGltf::Model *pModel,
+                   PackedVector3Array *pCollisionFaces )
 {
     int32_t numberOfPrimitives = countPrimitives( *pModel );
-    aMeshes.reserve( numberOfPrimitives );
     primitiveInfos.reserve( numberOfPrimitives );
+    Array surfaces;
 
     pModel->forEachPrimitiveInScene(
-        pModel->scene, [&aMeshes, &primitiveInfos, pModel](
+        pModel->scene, [&surfaces, &primitiveInfos, &images, pModel](
                            const CesiumGltf::Model &gltf, const CesiumGltf::Node &node,
                            const CesiumGltf::Mesh &mesh, const CesiumGltf::MeshPrimitive &primitive,
                            const glm::dmat4 &transform ) {
-            Ref<ArrayMesh> &aMesh = aMeshes.emplace_back();
-            aMesh.instantiate();
             CesiumPrimitiveInfo &primitiveInfo = primitiveInfos.emplace_back();
             auto positionAccessorIt = primitive.attributes.find( "POSITION" );
             if ( positionAccessorIt == primitive.attributes.end() )
@@ -1157,24 +1099,37 @@ void populateMeshDataArray( std::vector<Ref<ArrayMesh>> &aMeshes,
             }
 
             generateMipMapsForPrimitive( pModel, primitive );
+            loadImagesForPrimitive( gltf, primitive, images );
 
-            if ( primitive.indices < 0 || primitive.indices >= gltf.accessors.size() )
-            {
-                int32_t indexCount = static_cast<int32_t>( positionView.size() );
-                if ( indexCount > std::numeric_limits<std::uint16_t>::max() )
+            Dictionary surface;
+
+            // The index width follows the vertex count rather than the accessor's component
+            // type, so small primitives with 32-bit glTF indices still get 16-bit surfaces.
+            auto load = [&]( const auto &indicesView ) {
+                if ( !isValidIndexView( indicesView ) )
                 {
-                    loadPrimitive<std::uint32_t>( aMesh, primitiveInfo, gltf, node, mesh, primitive,
-                                                  transform,
-                                                  generateIndices<std::uint32_t>( indexCount ),
-                                                  IndexFormat::UInt32, positionView );
+                    SPDLOG_WARN( "Skipping primitive with an invalid index accessor." );
+                    return;
                 }
-                else
+                if ( positionView.size() <= maximumShortIndexVertexCount )
                 {
-                    loadPrimitive<std::uint16_t>( aMesh, primitiveInfo, gltf, node, mesh, primitive,
-                                                  transform,
-                                                  generateIndices<std::uint16_t>( indexCount ),
+                    loadPrimitive<std::uint16_t>( surface, primitiveInfo, gltf, node, mesh,
+                                                  primitive, transform, indicesView,
                                                   IndexFormat::UInt16, positionView );
                 }
+                else
+                {
+                    loadPrimitive<std::uint32_t>( surface, primitiveInfo, gltf, node, mesh,
+                                                  primitive, transform, indicesView,
+                                                  IndexFormat::UInt32, positionView );
+                }
+            };
+
+            if ( primitive.indices < 0 ||
+                 static_cast<size_t>( primitive.indices ) >= gltf.accessors.size() )
+            {
+                load( generateIndices<std::uint32_t>(
+                    static_cast<int32_t>( positionView.size() ) ) );
             }
             else
             {
@@ -1182,50 +1137,46 @@ void populateMeshDataArray( std::vector<Ref<ArrayMesh>> &aMeshes,
                 switch ( indexAccessorGltf.componentType )
                 {
                     case Accessor::ComponentType::BYTE:
-                    {
-                        AccessorView<int8_t> indexAccessor( gltf, primitive.indices );
-                        loadPrimitive<std::uint16_t>( aMesh, primitiveInfo, gltf, node, mesh,
-                                                      primitive, transform, indexAccessor,
-                                                      IndexFormat::UInt16, positionView );
+                        load( AccessorView<int8_t>( gltf, primitive.indices ) );
                         break;
-                    }
                     case Accessor::ComponentType::UNSIGNED_BYTE:
-                    {
-                        AccessorView<uint8_t> indexAccessor( gltf, primitive.indices );
-                        loadPrimitive<std::uint16_t>( aMesh, primitiveInfo, gltf, node, mesh,
-                                                      primitive, transform, indexAccessor,
-                                                      IndexFormat::UInt16, positionView );
+                        load( AccessorView<uint8_t>( gltf, primitive.indices ) );
                         break;
-                    }
                     case Accessor::ComponentType::SHORT:
-                    {
-                        AccessorView<int16_t> indexAccessor( gltf, primitive.indices );
-                        loadPrimitive<std::uint16_t>( aMesh, primitiveInfo, gltf, node, mesh,
-                                                      primitive, transform, indexAccessor,
-                                                      IndexFormat::UInt16, positionView );
+                        load( AccessorView<int16_t>( gltf, primitive.indices ) );
                         break;
-                    }
                     case Accessor::ComponentType::UNSIGNED_SHORT:
-                    {
-                        AccessorView<uint16_t> indexAccessor( gltf, primitive.indices );
-                        loadPrimitive<std::uint16_t>( aMesh, primitiveInfo, gltf, node, mesh,
-                                                      primitive, transform, indexAccessor,
-                                                      IndexFormat::UInt16, positionView );
+                        load( AccessorView<uint16_t>( gltf, primitive.indices ) );
                         break;
-                    }
                     case Accessor::ComponentType::UNSIGNED_INT:
-                    {
-                        AccessorView<uint32_t> indexAccessor( gltf, primitive.indices );
-                        loadPrimitive<std::uint32_t>( aMesh, primitiveInfo, gltf, node, mesh,
-                                                      primitive, transform, indexAccessor,
-                                                      IndexFormat::UInt32, positionView );
+                        load( AccessorView<uint32_t>( gltf, primitive.indices ) );
                         break;
-                    }
                     default:
-                        return;
+                        break;
                 }
             }
+
+            if ( !surface.is_empty() )
+            {
+                primitiveInfo.surfaceIndex = static_cast<int32_t>( surfaces.size() );
+                surfaces.push_back( surface );
+            }
         } );
+
+    if ( pCollisionFaces )
+    {
+        for ( int64_t i = 0; i < surfaces.size(); ++i )
+        {
+            appendCollisionFaces( *pCollisionFaces, surfaces[i] );
+        }
+    }
+
+    // Setting the surface data directly lets the mesh take the prebuilt buffers as is.
+    if ( !surfaces.is_empty() )
+    {
+        aMesh.instantiate();
+        aMesh->set( "_surfaces", surfaces );
+    }
 }
 
 GodotPrepareRendererResources::GodotPrepareRendererResources( Cesium3DTileset *tileset ) :
@@ -1245,11 +1196,26 @@ CesiumAsync::Future<Cesium3DTilesSelection::TileLoadResultAndRenderResources>
         return asyncSystem.createResolvedFuture(
             TileLoadResultAndRenderResources{ std::move( tileLoadResult ), nullptr } );
     }
-    std::vector<Ref<ArrayMesh>> meshes{};
-    std::vector<CesiumPrimitiveInfo> primitiveInfos{};
-    populateMeshDataArray( meshes, primitiveInfos, pModel );
+    // Collision isn't created in the editor.
+    const bool createPhysicsMeshes = this->_tileset->get_create_physics_meshes() &&
+                                     !godot::Engine::get_singleton()->is_editor_hint();
 
-    LoadThreadResult *pResult = new LoadThreadResult{ meshes, std::move( primitiveInfos ) };
+    Ref<ArrayMesh> mesh;
+    std::vector<CesiumPrimitiveInfo> primitiveInfos{};
+    DecodedImages images{};
+    PackedVector3Array collisionFaces;
+    populateMesh( mesh, primitiveInfos, images, pModel,
+                  createPhysicsMeshes ? &collisionFaces : nullptr );
+
+    // The concave shape, and the BVH the physics server builds for it, are made here, off the
+    // main thread. The shape isn't shared with anything until a body uses it, so that is safe.
+    // The faces are not kept once the shape has them.
+    RID collisionShape = createCollisionShape( collisionFaces );
+
+    LoadThreadResult *pResult = new LoadThreadResult{ std::move( mesh ),
+                                                      std::move( primitiveInfos ),
+                                                      std::move( images ),
+                                                      collisionShape };
     return asyncSystem.createResolvedFuture(
         TileLoadResultAndRenderResources{ std::move( tileLoadResult ), pResult } );
 }
@@ -1257,25 +1223,24 @@ CesiumAsync::Future<Cesium3DTilesSelection::TileLoadResultAndRenderResources>
 void *GodotPrepareRendererResources::prepareInMainThread( Cesium3DTilesSelection::Tile &tile,
                                                           void *pLoadThreadResult_ )
 {
+    std::unique_ptr<LoadThreadResult> pLoadThreadResult(
+        static_cast<LoadThreadResult *>( pLoadThreadResult_ ) );
     const Cesium3DTilesSelection::TileContent &content = tile.getContent();
     const Cesium3DTilesSelection::TileRenderContent *pRenderContent = content.getRenderContent();
-    if ( !pRenderContent )
+    if ( !pRenderContent || !pLoadThreadResult )
     {
         return nullptr;
     }
 
-    std::unique_ptr<LoadThreadResult> pLoadThreadResult(
-        static_cast<LoadThreadResult *>( pLoadThreadResult_ ) );
-    std::vector<Ref<ArrayMesh>> meshes = pLoadThreadResult->meshes;
-    std::vector<CesiumPrimitiveInfo> primitiveInfos = pLoadThreadResult->primitiveInfos;
+    Ref<ArrayMesh> mesh = pLoadThreadResult->mesh;
+    const std::vector<CesiumPrimitiveInfo> &primitiveInfos = pLoadThreadResult->primitiveInfos;
 
     const CesiumGltf::Model &model = pRenderContent->getModel();
     glm::dmat4 tileTransform = tile.getTransform();
     tileTransform = GltfUtilities::applyRtcCenter( model, tileTransform );
     GltfUtilities::applyGltfUpAxisTransform( model, tileTransform );
 
-    int32_t meshSize = meshes.size();
-    if ( !meshSize )
+    if ( mesh.is_null() )
     {
         return nullptr;
     }
@@ -1287,124 +1252,284 @@ void *GodotPrepareRendererResources::prepareInMainThread( Cesium3DTilesSelection
         name = urlIt->second.getStringOrDefault( "glTF" );
     }
 
-    std::vector<MeshInstance3D *> meshInstances;
-    meshInstances.reserve( meshSize );
-    for ( int i = 0; i < meshSize; ++i )
+    // cesium coordinate axis X is not align godot's, need rotate.
+    Quaternion qua( Vector3( 1, 0, 0 ), static_cast<real_t>( -Math_PI / 2 ) );
+    Transform3D trans;
+    trans.set_basis( qua );
+
+    // The whole tile is drawn at once, with one mesh surface per primitive: either by a node
+    // under the tileset, or by a bare RenderingServer instance in the tileset's scenario.
+    MeshInstance3D *meshInstance = nullptr;
+    RID instance;
+    Ref<World3D> world = this->_tileset->get_world_3d();
+    if ( this->_tileset->get_use_rendering_server_instances() && world.is_valid() )
+    {
+        RenderingServer *renderingServer = RenderingServer::get_singleton();
+        instance = renderingServer->instance_create2( mesh->get_rid(), world->get_scenario() );
+        renderingServer->instance_set_transform( instance,
+                                                 this->_tileset->get_global_transform() * trans );
+        renderingServer->instance_set_visible( instance, false );
+    }
+    else
     {
-        MeshInstance3D *meshInstance = memnew( MeshInstance3D );
+        meshInstance = memnew( MeshInstance3D );
         meshInstance->set_name( godot::String( name.c_str() ) );
-        meshInstance->set_mesh( meshes[i] );
-        // cesium coordinate axis X is not align godot's, need rotate.
-        Quaternion qua( Vector3( 1, 0, 0 ), static_cast<real_t>( -Math_PI / 2 ) );
-        Transform3D trans;
-        trans.set_basis( qua );
+        meshInstance->set_mesh( mesh );
         meshInstance->set_transform( trans );
         meshInstance->set_visible( false );
         this->_tileset->add_child( meshInstance );
-        meshInstances.push_back( meshInstance );
     }
 
-    const bool createPhysicsMeshes = this->_tileset->get_create_physics_meshes();
+    // Textures come from the tileset-wide cache; every reference taken here is given back when
+    // the tile is freed.
+    std::vector<const CesiumGltf::ImageAsset *> textures;
+    TextureLoader loadTexture = [this, &model, &textures,
+                                 &images = pLoadThreadResult->images]( int32_t textureIndex ) {
+        const CesiumGltf::Texture *pTexture = Model::getSafe( &model.textures, textureIndex );
+        const CesiumGltf::Image *pImage =
+            pTexture ? Model::getSafe( &model.images, pTexture->source ) : nullptr;
+        if ( !pImage || !pImage->pAsset )
+        {
+            return Ref<ImageTexture>();
+        }
 
-    int32_t meshIndex = 0;
+        auto imageIt = images.find( pImage->pAsset.get() );
+        Ref<ImageTexture> texture = this->acquireTexture(
+            pImage->pAsset, imageIt != images.end() ? imageIt->second : Ref<godot::Image>() );
+        if ( texture.is_valid() )
+        {
+            textures.push_back( pImage->pAsset.get() );
+        }
+        return texture;
+    };
+
+    // Identical materials are shared across primitives and tiles.
+    std::vector<MaterialKey> materialKeys;
+
+    int32_t primitiveIndex = 0;
     model.forEachPrimitiveInScene(
-        model.scene, [&meshes, &meshIndex, &meshInstances, &primitiveInfos, &createPhysicsMeshes, model](
+        model.scene, [this, &mesh, &primitiveIndex, &primitiveInfos, &loadTexture,
+                      &materialKeys](
                          const CesiumGltf::Model &gltf, const CesiumGltf::Node &node,
-                         const CesiumGltf::Mesh &mesh, const CesiumGltf::MeshPrimitive &primitive,
+                         const CesiumGltf::Mesh &gltfMesh,
+                         const CesiumGltf::MeshPrimitive &primitive,
                          const glm::dmat4 &transform ) {
-            const CesiumPrimitiveInfo &primitiveInfo = primitiveInfos[meshIndex];
-            Ref<ArrayMesh> ArrayMeshRef = meshes[meshIndex];
-            MeshInstance3D *meshInstance = meshInstances[meshIndex];
-            meshIndex++;
-            auto positionAccessorIt = primitive.attributes.find( "POSITION" );
-            if ( positionAccessorIt == primitive.attributes.end() )
-            {
-                // This primitive doesn't have a POSITION semantic, ignore it.
-                return;
-            }
-
-            int32_t positionAccessorID = positionAccessorIt->second;
-            AccessorView<Vector3> positionView( gltf, positionAccessorID );
-            if ( positionView.status() != AccessorViewStatus::Valid )
+            const CesiumPrimitiveInfo &primitiveInfo = primitiveInfos[primitiveIndex++];
+            if ( primitiveInfo.surfaceIndex < 0 )
             {
+                // The primitive has no usable geometry, so it got no surface.
                 return;
             }
 
-            Ref<StandardMaterial3D> material;
-            material.instantiate();
-
+            MaterialKey materialKey;
             const CesiumGltf::Material *pMaterial =
                 Model::getSafe( &gltf.materials, primitive.material );
             if ( pMaterial )
             {
-                setGltfMaterialParameterValues( gltf, primitiveInfo, *pMaterial, material);
-            }
-            meshInstance->set_material_override( material );
-
-            if ( primitiveInfo.containsPoints )
-            {
-                // TODO: pointClound
-
-                return;
-            }
-
-            if ( createPhysicsMeshes )
-            {
-                if ( !godot::Engine::get_singleton()->is_editor_hint() &&
-                     !isDegenerateTriangleMesh( ArrayMeshRef ) )
-                {
-
-                    meshInstance->create_convex_collision();
-                }
+                materialKey = resolveMaterialKey( gltf, loadTexture, primitiveInfo, *pMaterial );
+                materialKey.hasGltfMaterial = true;
             }
+            Ref<StandardMaterial3D> material = this->acquireMaterial( materialKey );
+            materialKeys.push_back( std::move( materialKey ) );
+            mesh->surface_set_material( primitiveInfo.surfaceIndex, material );
         } );
 
-    return new CesiumGltfNode{ std::move( meshInstances ),
-                               std::move( pLoadThreadResult->primitiveInfos ), false };
+
+    CesiumGltfNode *pGltfNode = new CesiumGltfNode{
+        meshInstance, std::move( pLoadThreadResult->primitiveInfos ), false };
+    pGltfNode->textures = std::move( textures );
+    pGltfNode->materials = std::move( materialKeys );
+    pGltfNode->instance = instance;
+    pGltfNode->mesh = instance.is_valid() ? mesh : Ref<ArrayMesh>();
+    pGltfNode->localTransform = trans;
+    pGltfNode->tilesetVisible = this->_tileset->is_visible_in_tree();
+    // Bodies are created later, by the tileset's collision selection pass.
+    pGltfNode->collision.shape = pLoadThreadResult->collisionShape;
+    pLoadThreadResult->collisionShape = RID();
+    pGltfNode->bounds = mesh->get_aabb();
+    return pGltfNode;
 }
 
 void GodotPrepareRendererResources::free( Cesium3DTilesSelection::Tile &tile,
                                           void *pLoadThreadResult,
                                           void *pMainThreadResult ) noexcept
 {
-    if (this->_tileset->tiles_destroyed)
+    // While the tileset is being destroyed, its tile nodes are freed along with it and its tile
+    // bookkeeping may already be gone; everything else is released as usual.
+    const bool tilesetDestroyed = this->_tileset->tiles_destroyed;
+    if ( !tilesetDestroyed )
     {
-        return;
+        SPDLOG_INFO( "prepare to free resources" );
     }
-    SPDLOG_INFO("prepare to free resources");
     if ( pLoadThreadResult )
     {
-        LoadThreadResult *result = static_cast<LoadThreadResult *>( pLoadThreadResult );
-        result->meshes.clear();
-        delete result;
+        delete static_cast<LoadThreadResult *>( pLoadThreadResult );
     }
     if ( pMainThreadResult )
     {
         CesiumGltfNode *pGltfNode = static_cast<CesiumGltfNode *>( pMainThreadResult );
-        if (!pGltfNode->isFreed)
+        if ( !pGltfNode->isFreed )
         {
-            for ( MeshInstance3D *meshInstance : pGltfNode->pNodes )
+            MeshInstance3D *meshInstance = pGltfNode->pNode;
+            if ( !tilesetDestroyed && meshInstance && meshInstance->is_inside_tree() )
             {
-                if (meshInstance && meshInstance->is_inside_tree())
+                godot::Node *parent = meshInstance->get_parent();
+                if ( parent )
                 {
-                    godot::Node *parent = meshInstance->get_parent();
-                    if (parent)
-                    {
-                        parent->remove_child(meshInstance);
-                    }
-                    // 由Godot负责内存释放，避免手动delete
-                    meshInstance->queue_free();
+                    parent->remove_child( meshInstance );
                 }
+                // The node is freed by Godot; deleting it here would free it twice.
+                meshInstance->queue_free();
+            }
+            pGltfNode->pNode = nullptr;
+            pGltfNode->free_server_objects();
+            if ( !tilesetDestroyed )
+            {
+                this->_tileset->forget_tile_node( pGltfNode );
+            }
+            for ( const MaterialKey &materialKey : pGltfNode->materials )
+            {
+                this->releaseMaterial( materialKey );
+            }
+            for ( const CesiumGltf::ImageAsset *pAsset : pGltfNode->textures )
+            {
+                this->releaseTexture( pAsset );
             }
-            pGltfNode->pNodes.clear();
             pGltfNode->isFreed = true;
             delete pGltfNode;
-        } else{
-            SPDLOG_WARN("pGltfNode: {} already freed!", (void*)pGltfNode);
+        }
+        else
+        {
+            SPDLOG_WARN( "pGltfNode: {} already freed!", (void *)pGltfNode );
         }
     }
 }
 
+Ref<ImageTexture> GodotPrepareRendererResources::acquireTexture(
+    const decltype( CesiumGltf::Image::pAsset ) &pAsset, const Ref<godot::Image> &image )
+{
+    auto it = this->_textures.find( pAsset.get() );
+    if ( it == this->_textures.end() )
+    {
+        if ( image.is_null() )
+        {
+            return Ref<ImageTexture>();
+        }
+        it = this->_textures
+                 .emplace( pAsset.get(),
+                           CachedTexture{ pAsset, ImageTexture::create_from_image( image ), 0 } )
+                 .first;
+    }
+    ++it->second.references;
+    return it->second.texture;
+}
+
+void GodotPrepareRendererResources::releaseTexture( const CesiumGltf::ImageAsset *pAsset )
+{
+    auto it = this->_textures.find( pAsset );
+    if ( it != this->_textures.end() && --it->second.references <= 0 )
+    {
+        this->_textures.erase( it );
+    }
+}
+
+const CesiumGltf::SupportedGpuCompressedPixelFormats &CesiumForGodot::
+    getSupportedGpuCompressedPixelFormats()
+{
+    static const SupportedGpuCompressedPixelFormats supportedFormats = []() {
+        RenderingServer *renderingServer = RenderingServer::get_singleton();
+        const bool s3tc = renderingServer->has_os_feature( "s3tc" );
+        const bool rgtc = renderingServer->has_os_feature( "rgtc" );
+        const bool bptc = renderingServer->has_os_feature( "bptc" );
+        const bool etc2 = renderingServer->has_os_feature( "etc2" );
+        const bool astc = renderingServer->has_os_feature( "astc" );
+
+        SupportedGpuCompressedPixelFormats formats;
+        // ETC1 data is valid ETC2 data.
+        formats.ETC1_RGB = etc2;
+        formats.ETC2_RGBA = etc2;
+        formats.ETC2_EAC_R11 = etc2;
+        formats.ETC2_EAC_RG11 = etc2;
+        formats.BC1_RGB = s3tc;
+        formats.BC3_RGBA = s3tc;
+        formats.BC4_R = rgtc;
+        formats.BC5_RG = rgtc;
+        formats.BC7_RGBA = bptc;
+        formats.ASTC_4x4_RGBA = astc;
+        // Godot can't take PVRTC at all, so cesium-native transcodes to uncompressed RGBA
+        // rather than to PVRTC on devices without any of the formats above.
+        formats.PVRTC1_4_RGB = false;
+        formats.PVRTC1_4_RGBA = false;
+        formats.PVRTC2_4_RGB = false;
+        formats.PVRTC2_4_RGBA = false;
+        return formats;
+    }();
+    return supportedFormats;
+}
+
+Ref<StandardMaterial3D> GodotPrepareRendererResources::acquireMaterial( const MaterialKey &key )
+{
+    auto it = this->_materials.find( key );
+    if ( it == this->_materials.end() )
+    {
+        it = this->_materials.emplace( key, CachedMaterial{ createMaterial( key ), 0 } ).first;
+    }
+    ++it->second.references;
+    return it->second.material;
+}
+
+void GodotPrepareRendererResources::releaseMaterial( const MaterialKey &key )
+{
+    auto it = this->_materials.find( key );
+    if ( it != this->_materials.end() && --it->second.references <= 0 )
+    {
+        this->_materials.erase( it );
+    }
+}
+
+bool MaterialKey::operator==( const MaterialKey &other ) const
+{
+    // Textures come from the tileset's texture cache, so comparing them by identity is enough.
+    return hasGltfMaterial == other.hasGltfMaterial && albedo == other.albedo &&
+           metallic == other.metallic && roughness == other.roughness && unlit == other.unlit &&
+           albedoTexture == other.albedoTexture && metallicTexture == other.metallicTexture &&
+           emissionTexture == other.emissionTexture && normalTexture == other.normalTexture &&
+           occlusionTexture == other.occlusionTexture && textureFilter == other.textureFilter &&
+           uv1Scale == other.uv1Scale && uv1Offset == other.uv1Offset;
+}
+
+size_t MaterialKey::hash() const
+{
+    size_t seed = 0;
+    auto combine = [&seed]( size_t value ) {
+        seed ^= value + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+    };
+    auto combineFloat = [&combine]( real_t value ) { combine( std::hash<real_t>()( value ) ); };
+    auto combineTexture = [&combine]( const Ref<Texture2D> &texture ) {
+        combine( std::hash<const void *>()( texture.ptr() ) );
+    };
+
+    combine( hasGltfMaterial );
+    combineFloat( albedo.r );
+    combineFloat( albedo.g );
+    combineFloat( albedo.b );
+    combineFloat( albedo.a );
+    combineFloat( metallic );
+    combineFloat( roughness );
+    combine( unlit );
+    combineTexture( albedoTexture );
+    combineTexture( metallicTexture );
+    combineTexture( emissionTexture );
+    combineTexture( normalTexture );
+    combineTexture( occlusionTexture );
+    combine( textureFilter );
+    combineFloat( uv1Scale.x );
+    combineFloat( uv1Scale.y );
+    combineFloat( uv1Offset.x );
+    combineFloat( uv1Offset.y );
+    return seed;
+}
+
 void *GodotPrepareRendererResources::prepareRasterInLoadThread( CesiumGltf::ImageAsset &image,
                                                                 const std::any &rendererOptions )
 {
@@ -3,6 +3,7 @@
 
 #include "Cesium3DTileset.h"
 #include <Cesium3DTilesSelection/IPrepareRendererResources.h>
+#include <CesiumAsync/AsyncSystem.h>
 #include <Cesium3DTilesSelection/Tile.h>
 #include <Cesium3DTilesSelection/Tileset.h>
 #include <CesiumGeometry/Transforms.h>
@@ -12,6 +13,7 @@
 #include <CesiumGltf/ExtensionKhrTextureTransform.h>
 #include <CesiumGltf/ExtensionModelExtStructuralMetadata.h>
 #include <CesiumGltf/KhrTextureTransform.h>
+#include <CesiumGltf/Ktx2TranscodeTargets.h>
 #include <CesiumGltfContent/GltfUtilities.h>
 #include <CesiumGltfReader/GltfReader.h>
 #include <CesiumUtility/ScopeGuard.h>
@@ -25,6 +27,7 @@
 #include <godot_cpp/classes/image_texture.hpp>
 #include <godot_cpp/classes/mesh_instance3d.hpp>
 #include <godot_cpp/classes/random_number_generator.hpp>
+#include <godot_cpp/classes/standard_material3d.hpp>
 #include <godot_cpp/templates/vector.hpp>
 #include <godot_cpp/variant/color.hpp>
 
@@ -85,6 +88,12 @@ namespace CesiumForGodot
          */
         bool containsPoints = false;
 
+        /**
+         * @brief The index of the primitive's surface in the tile's ArrayMesh, or -1 if the
+         * primitive has no geometry and therefore no surface.
+         */
+        int32_t surfaceIndex = -1;
+
         /**
          * @brief Whether or not the primitive contains translucent vertex
          * colors. This can affect material tags used to render the model.
@@ -110,15 +119,70 @@ namespace CesiumForGodot
         std::unordered_map<uint32_t, uint32_t> rasterOverlayUvIndexMap{};
     };
 
+    /**
+     * @brief The resolved parameters of a glTF material as applied to a StandardMaterial3D.
+     * Primitives whose keys compare equal share one material.
+     */
+    struct MaterialKey
+    {
+        /**
+         * @brief Whether the primitive has a glTF material at all. Without one, the
+         * StandardMaterial3D defaults are used and the other fields are ignored.
+         */
+        bool hasGltfMaterial = false;
+
+        Color albedo{ 1, 1, 1, 1 };
+        float metallic = 0.0f;
+        float roughness = 1.0f;
+        bool unlit = false;
+
+        Ref<Texture2D> albedoTexture;
+        Ref<Texture2D> metallicTexture;
+        Ref<Texture2D> emissionTexture;
+        Ref<Texture2D> normalTexture;
+        Ref<Texture2D> occlusionTexture;
+        BaseMaterial3D::TextureFilter textureFilter =
+            BaseMaterial3D::TEXTURE_FILTER_LINEAR_WITH_MIPMAPS;
+
+        Vector3 uv1Scale{ 1, 1, 1 };
+        Vector3 uv1Offset{ 0, 0, 0 };
+
+        bool operator==( const MaterialKey &other ) const;
+        size_t hash() const;
+    };
+
+    /**
+     * @brief The PhysicsServer3D objects colliding with a glTF.
+     */
+    struct CesiumGltfCollision
+    {
+        /**
+         * @brief The concave shape of all surfaces, built on the load thread along with the
+         * mesh. The body using it only exists while the tileset wants the glTF to collide.
+         */
+        RID shape{};
+        RID body{};
+
+        /**
+         * @brief Set once the shape was built from the mesh on the main thread, for a glTF that
+         * was loaded while the tileset did not create physics meshes.
+         */
+        bool shapeRebuilt = false;
+
+        void create_body( const Transform3D &transform, const RID &space );
+        void free_body();
+    };
+
     /**
      * @brief The fully loaded Node3D object for this glTF and associated information.
      */
     struct CesiumGltfNode
     {
         /**
-         * @brief The fully loaded Godot Node3D object for this glTF.
+         * @brief The fully loaded Godot Node3D object for this glTF. Its mesh has one surface
+         * per primitive.
          */
-        std::vector<MeshInstance3D *> pNodes;
+        MeshInstance3D *pNode = nullptr;
 
         /**
          * @brief Information about how glTF mesh primitives were translated to Godot
@@ -126,19 +190,77 @@ namespace CesiumForGodot
          */
         std::vector<CesiumPrimitiveInfo> primitiveInfos{};
 
-        void set_visible( bool b )
-        {
-            for ( MeshInstance3D *inst : pNodes )
-            {
-                inst->set_visible( b );
-            }
-            visible = b;
-        }
+        void set_visible( bool b );
+
+        /**
+         * @brief Moves the RenderingServer instance and collision body along with the tileset,
+         * and shows or hides the instance with it. Tile nodes follow their parent on their own.
+         */
+        void update_server_objects( const Transform3D &tilesetTransform, bool tilesetVisible );
 
         bool visible = false;
         bool isFreed = false;
+
+        /**
+         * @brief When the tileset uses RenderingServer instances, the instance drawing this
+         * glTF in place of pNode.
+         */
+        RID instance{};
+
+        /**
+         * @brief The mesh drawn by instance, kept alive for as long as the instance is.
+         */
+        Ref<ArrayMesh> mesh{};
+
+        /**
+         * @brief The transform of the glTF relative to the tileset.
+         */
+        Transform3D localTransform{};
+
+        bool tilesetVisible = true;
+
+        /**
+         * @brief The bounds of the mesh, in its own space.
+         */
+        AABB bounds{};
+
+        CesiumGltfCollision collision{};
+
+        /**
+         * @brief Creates or frees the static body colliding with this glTF. A glTF loaded
+         * without a collision shape gets one built from its mesh first.
+         */
+        void update_collision( bool wanted, const Transform3D &tilesetTransform,
+                               const RID &space );
+
+        /**
+         * @brief Builds the collision shape from the mesh, on the main thread.
+         */
+        void rebuild_collision_shape();
+
+        /**
+         * @brief Frees the RenderingServer and PhysicsServer3D objects owned by this glTF.
+         */
+        void free_server_objects();
+
+        /**
+         * @brief The images whose cached textures this glTF holds a reference to, once per
+         * reference taken.
+         */
+        std::vector<const CesiumGltf::ImageAsset *> textures{};
+
+        /**
+         * @brief The keys of the shared materials this glTF holds a reference to.
+         */
+        std::vector<MaterialKey> materials{};
     };
 
+    /**
+     * GPU-compressed texture formats the active rendering device can sample, queried from the
+     * RenderingServer on first use. Must first be called from the main thread.
+     */
+    const CesiumGltf::SupportedGpuCompressedPixelFormats &getSupportedGpuCompressedPixelFormats();
+
     class GodotPrepareRendererResources : public Cesium3DTilesSelection::IPrepareRendererResources
     {
     public:
@@ -177,33 +299,55 @@ namespace CesiumForGodot
             const CesiumRasterOverlays::RasterOverlayTile &rasterTile,
             void *pMainThreadRendererResources ) noexcept override;
 
-    private:
-        Cesium3DTileset *_tileset;
-    };
+        /**
+         * Returns the texture created from an image asset, creating it from the decoded image
+         * if it isn't cached yet. Each successful call takes a reference that is given back
+         * with releaseTexture(). Main thread only.
+         */
+        Ref<ImageTexture> acquireTexture( const decltype( CesiumGltf::Image::pAsset ) &pAsset,
+                                          const Ref<godot::Image> &image );
 
-    template <typename TIndex>
-    void computeFlatNormals( uint8_t *pWritePos, size_t stride, TIndex *indices, int32_t indexCount,
-                             const CesiumGltf::AccessorView<glm::vec3> &positionView )
-    {
+        void releaseTexture( const CesiumGltf::ImageAsset *pAsset );
+
+        /**
+         * Returns the shared material for a key, creating it on first use. Each call takes a
+         * reference that is given back with releaseMaterial(). Main thread only.
+         */
+        Ref<StandardMaterial3D> acquireMaterial( const MaterialKey &key );
 
-        for ( int i = 0; i < indexCount; i += 3 )
+        void releaseMaterial( const MaterialKey &key );
+
+    private:
+        struct CachedTexture
         {
-            TIndex i0 = indices[i];
-            TIndex i1 = indices[i + 1];
-            TIndex i2 = indices[i + 2];
+            // Keeps the asset, and so the cache key, from being reused while cached.
+            decltype( CesiumGltf::Image::pAsset ) pAsset;
+            Ref<ImageTexture> texture;
+            int32_t references;
+        };
 
-            const glm::vec3 &v0 = *reinterpret_cast<const glm::vec3 *>( &positionView[i0] );
-            const glm::vec3 &v1 = *reinterpret_cast<const glm::vec3 *>( &positionView[i1] );
-            const glm::vec3 &v2 = *reinterpret_cast<const glm::vec3 *>( &positionView[i2] );
+        Cesium3DTileset *_tileset;
+
+        struct CachedMaterial
+        {
+            Ref<StandardMaterial3D> material;
+            int32_t references;
+        };
 
-            glm::vec3 normal = glm::normalize( glm::cross( v1 - v0, v2 - v0 ) );
-            for ( int j = 0; j < 3; j++ )
+        struct MaterialKeyHash
+        {
+            size_t operator()( const MaterialKey &key ) const
             {
-                *reinterpret_cast<glm::vec3 *>( pWritePos ) = normal;
-                pWritePos += stride;
+                return key.hash();
             }
-        }
-    }
+        };
+
+        // Textures shared by all tiles of the tileset, keyed by the image they were made from.
+        std::unordered_map<const CesiumGltf::ImageAsset *, CachedTexture> _textures;
+
+        // Materials shared by all tiles of the tileset.
+        std::unordered_map<MaterialKey, CachedMaterial, MaterialKeyHash> _materials;
+    };
 
 } // namespace CesiumForGodot
 
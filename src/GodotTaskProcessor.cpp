@@ -1,16 +1,17 @@
-#pragma once
+#include "GodotTaskProcessor.h"
 
-#include <future>
 #include <functional>
 
-#include "GodotTaskProcessor.h"
-
+namespace CesiumForGodot
+{
 
-namespace CesiumForGodot {
+    GodotTaskProcessor::GodotTaskProcessor( thread_pool &pool ) : _pool( pool )
+    {
+    }
 
-  void GodotTaskProcessor::startTask(std::function<void()> f) {
-    std::async(std::launch::async, f);    
-  }
+    void GodotTaskProcessor::startTask( std::function<void()> f )
+    {
+        _pool.enqueueWork( std::move( f ) );
+    }
 
 } // namespace CesiumForGodot
-
@@ -1,15 +1,25 @@
 #ifndef GODOT_TASK_PROCESSOR_H
 #define GODOT_TASK_PROCESSOR_H
 
+#include "ThreadUtils.hpp"
 #include <CesiumAsync/ITaskProcessor.h>
 
 namespace CesiumForGodot
 {
+    /**
+     * Runs cesium-native worker continuations (tile content decode, prepareInLoadThread, ...)
+     * on a persistent pool of threads instead of blocking the calling thread.
+     */
     class GodotTaskProcessor : public CesiumAsync::ITaskProcessor
     {
     public:
+        explicit GodotTaskProcessor( thread_pool &pool );
+
         virtual void startTask( std::function<void()> f ) override;
+
+    private:
+        thread_pool &_pool;
     };
 } // namespace CesiumForGodot
 
-#endif
\ No newline at end of file
+#endif
@@ -1,4 +1,5 @@
 #include "GodotTilesetExternals.h"
+#include "CesiumSettings.h"
 #include "GodotAssetAccessor.h"
 #include "GodotPrepareRendererResources.h"
 #include "GodotTaskProcessor.h"
@@ -18,6 +19,7 @@ namespace CesiumForGodot
     namespace
     {
         std::shared_ptr<IAssetAccessor> pAccessor = nullptr;
+        std::shared_ptr<GodotAssetAccessor> pGodotAccessor = nullptr;
         std::shared_ptr<ITaskProcessor> pTaskProcessor = nullptr;
         std::shared_ptr<CreditSystem> pCreditSystem = nullptr;
         std::optional<AsyncSystem> asyncSystem;
@@ -33,7 +35,7 @@ namespace CesiumForGodot
 
             pAccessor =
                 std::make_shared<GunzipAssetAccessor>( std::make_shared<CachingAssetAccessor>(
-                    spdlog::default_logger(), std::make_shared<GodotAssetAccessor>(),
+                    spdlog::default_logger(), getGodotAssetAccessor(),
                     std::make_shared<SqliteCache>( spdlog::default_logger(), cacheDBPath,
                                                    maxItems ),
                     requestsPerCachePrune ) );
@@ -41,15 +43,34 @@ namespace CesiumForGodot
         return pAccessor;
     }
 
+    const std::shared_ptr<GodotAssetAccessor> &getGodotAssetAccessor()
+    {
+        if ( !pGodotAccessor )
+        {
+            pGodotAccessor = std::make_shared<GodotAssetAccessor>();
+            pGodotAccessor->setMaximumConnectionsPerHost(
+                Settings::getMaximumConnectionsPerHost() );
+            pGodotAccessor->setTickTimeBudget( Settings::getNetworkTickTimeBudget() );
+            pGodotAccessor->setRequestTimeout( Settings::getRequestTimeout() );
+        }
+        return pGodotAccessor;
+    }
+
     const std::shared_ptr<ITaskProcessor> &getTaskProcessor()
     {
         if ( !pTaskProcessor )
         {
-            pTaskProcessor = std::make_shared<GodotTaskProcessor>();
+            pTaskProcessor = std::make_shared<GodotTaskProcessor>( getWorkerPool() );
         }
         return pTaskProcessor;
     }
 
+    thread_pool &getWorkerPool()
+    {
+        static thread_pool pool( Settings::getWorkerThreadCount() );
+        return pool;
+    }
+
     AsyncSystem getAsyncSystem()
     {
         if ( !asyncSystem )
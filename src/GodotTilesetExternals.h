@@ -2,6 +2,7 @@
 #define GODOT_TILESET_EXTERNALS_H
 
 #include "Cesium3DTileset.h"
+#include "ThreadUtils.hpp"
 #include <Cesium3DTilesSelection/TilesetExternals.h>
 #include <memory>
 
@@ -24,8 +25,15 @@ namespace CesiumAsync
 
 namespace CesiumForGodot
 {
+    class GodotAssetAccessor;
+
     const std::shared_ptr<CesiumAsync::IAssetAccessor> &getAssetAccessor();
+    // The network/file accessor at the bottom of the caching and gunzip accessor chain.
+    const std::shared_ptr<GodotAssetAccessor> &getGodotAssetAccessor();
     const std::shared_ptr<CesiumAsync::ITaskProcessor> &getTaskProcessor();
+
+    // The worker pool shared by the task processor and the local file loader.
+    thread_pool &getWorkerPool();
     CesiumAsync::AsyncSystem getAsyncSystem();
 
     // Gets the credit system on the input Cesium3DTileset. If it does not exist,
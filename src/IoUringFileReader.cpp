@@ -0,0 +1,315 @@
+#include "IoUringFileReader.h"
+
+#ifdef GODOT_3DTILES_USE_IO_URING
+
+#include <liburing.h>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+    const unsigned queueDepth = 256;
+
+    // A single read can't be larger than this; bigger files are read in several chunks.
+    const size_t maximumReadSize = size_t( 1 ) << 30;
+
+    struct FileRead
+    {
+        int fd = -1;
+        std::vector<std::byte> data;
+        size_t offset = 0;
+        CesiumForGodot::FileReadCallback callback;
+    };
+
+    class IoUringFileReader
+    {
+    public:
+        static std::unique_ptr<IoUringFileReader> create()
+        {
+            std::unique_ptr<IoUringFileReader> pReader( new IoUringFileReader() );
+            if ( io_uring_queue_init( queueDepth, &pReader->_ring, 0 ) < 0 )
+            {
+                return nullptr;
+            }
+            pReader->_ringInitialized = true;
+
+            pReader->_wakeFd = eventfd( 0, EFD_CLOEXEC );
+            if ( pReader->_wakeFd < 0 )
+            {
+                return nullptr;
+            }
+
+            pReader->_thread = std::thread( &IoUringFileReader::run, pReader.get() );
+            return pReader;
+        }
+
+        ~IoUringFileReader()
+        {
+            if ( _thread.joinable() )
+            {
+                _done = true;
+                wake();
+                _thread.join();
+            }
+
+            // Only reachable at shutdown; the callbacks of reads still in flight are dropped.
+            for ( const std::unique_ptr<FileRead> &pRead : _pendingReads )
+            {
+                ::close( pRead->fd );
+            }
+            if ( _wakeFd >= 0 )
+            {
+                ::close( _wakeFd );
+            }
+            if ( _ringInitialized )
+            {
+                io_uring_queue_exit( &_ring );
+            }
+        }
+
+        bool read( const std::string &filename, CesiumForGodot::FileReadCallback &&callback )
+        {
+            if ( _dead )
+            {
+                return false;
+            }
+
+            // Opening is left synchronous on the calling worker: it is cheap next to the read,
+            // and doing it here keeps error reporting simple.
+            int fd = ::open( filename.c_str(), O_RDONLY | O_CLOEXEC );
+            struct stat st;
+            if ( fd < 0 || ::fstat( fd, &st ) != 0 || !S_ISREG( st.st_mode ) )
+            {
+                if ( fd >= 0 )
+                {
+                    ::close( fd );
+                }
+                callback( 404, {} );
+                return true;
+            }
+            if ( st.st_size == 0 )
+            {
+                ::close( fd );
+                callback( 200, {} );
+                return true;
+            }
+
+            auto pRead = std::make_unique<FileRead>();
+            pRead->fd = fd;
+            pRead->data.resize( static_cast<size_t>( st.st_size ) );
+            {
+                std::lock_guard<std::mutex> lock( _pendingMutex );
+                if ( _dead )
+                {
+                    ::close( fd );
+                    return false;
+                }
+                pRead->callback = std::move( callback );
+                _pendingReads.push_back( std::move( pRead ) );
+            }
+
+            // Only the first read queued since the completion thread last drained the queue
+            // needs to wake it up.
+            if ( !_wakeRequested.exchange( true ) )
+            {
+                wake();
+            }
+            return true;
+        }
+
+    private:
+        IoUringFileReader() = default;
+
+        void wake()
+        {
+            uint64_t value = 1;
+            [[maybe_unused]] ssize_t written = ::write( _wakeFd, &value, sizeof( value ) );
+        }
+
+        void run()
+        {
+            std::vector<std::unique_ptr<FileRead>> retries;
+            bool wakeArmed = false;
+
+            while ( !_done )
+            {
+                // The eventfd read completes as soon as another thread calls wake(), which
+                // interrupts the wait below.
+                if ( !wakeArmed )
+                {
+                    io_uring_sqe *sqe = io_uring_get_sqe( &_ring );
+                    io_uring_prep_read( sqe, _wakeFd, &_wakeValue, sizeof( _wakeValue ), 0 );
+                    io_uring_sqe_set_data( sqe, nullptr );
+                    wakeArmed = true;
+                }
+
+                _wakeRequested = false;
+                for ( std::unique_ptr<FileRead> &pRead : retries )
+                {
+                    queueRead( std::move( pRead ) );
+                }
+                retries.clear();
+                {
+                    std::lock_guard<std::mutex> lock( _pendingMutex );
+                    while ( !_pendingReads.empty() && _inFlightReads.size() < queueDepth - 1 &&
+                            io_uring_sq_space_left( &_ring ) > 0 )
+                    {
+                        queueRead( std::move( _pendingReads.front() ) );
+                        _pendingReads.pop_front();
+                    }
+                }
+
+                int result = io_uring_submit_and_wait( &_ring, 1 );
+                if ( result < 0 && result != -EINTR && result != -EAGAIN && result != -EBUSY )
+                {
+                    fail( retries );
+                    return;
+                }
+
+                unsigned head;
+                unsigned count = 0;
+                io_uring_cqe *cqe;
+                io_uring_for_each_cqe( &_ring, head, cqe )
+                {
+                    ++count;
+                    auto *pRead = static_cast<FileRead *>( io_uring_cqe_get_data( cqe ) );
+                    if ( !pRead )
+                    {
+                        wakeArmed = false;
+                        continue;
+                    }
+
+                    _inFlightReads.erase( pRead );
+                    std::unique_ptr<FileRead> pOwner( pRead );
+                    if ( cqe->res == -EINTR || cqe->res == -EAGAIN )
+                    {
+                        retries.push_back( std::move( pOwner ) );
+                        continue;
+                    }
+                    if ( cqe->res <= 0 )
+                    {
+                        // An error, or the file shrank since it was opened.
+                        finish( *pOwner, 404 );
+                        continue;
+                    }
+
+                    pOwner->offset += static_cast<size_t>( cqe->res );
+                    if ( pOwner->offset < pOwner->data.size() )
+                    {
+                        // Short read; continue from where it stopped.
+                        retries.push_back( std::move( pOwner ) );
+                        continue;
+                    }
+                    finish( *pOwner, 200 );
+                }
+                io_uring_cq_advance( &_ring, count );
+            }
+        }
+
+        void queueRead( std::unique_ptr<FileRead> &&pRead )
+        {
+            io_uring_sqe *sqe = io_uring_get_sqe( &_ring );
+            size_t size = std::min( pRead->data.size() - pRead->offset, maximumReadSize );
+            io_uring_prep_read( sqe, pRead->fd, pRead->data.data() + pRead->offset,
+                                static_cast<unsigned>( size ), pRead->offset );
+            _inFlightReads.insert( pRead.get() );
+            io_uring_sqe_set_data( sqe, pRead.release() );
+        }
+
+        // Called on the completion thread when the ring can't be used anymore. Later reads are
+        // refused, and the ones already queued are handed back with a status of 0.
+        void fail( std::vector<std::unique_ptr<FileRead>> &retries )
+        {
+            std::deque<std::unique_ptr<FileRead>> pendingReads;
+            {
+                std::lock_guard<std::mutex> lock( _pendingMutex );
+                _dead = true;
+                pendingReads.swap( _pendingReads );
+            }
+
+            // Tearing down the ring cancels the reads still in the kernel, so their buffers
+            // can be released afterwards.
+            io_uring_queue_exit( &_ring );
+            _ringInitialized = false;
+
+            for ( FileRead *pRead : _inFlightReads )
+            {
+                retries.emplace_back( pRead );
+            }
+            _inFlightReads.clear();
+            for ( std::unique_ptr<FileRead> &pRead : pendingReads )
+            {
+                retries.push_back( std::move( pRead ) );
+            }
+            for ( std::unique_ptr<FileRead> &pRead : retries )
+            {
+                finish( *pRead, 0 );
+            }
+            retries.clear();
+        }
+
+        static void finish( FileRead &read, uint16_t statusCode )
+        {
+            ::close( read.fd );
+            if ( statusCode != 200 )
+            {
+                read.data.clear();
+            }
+            read.callback( statusCode, std::move( read.data ) );
+        }
+
+        io_uring _ring{};
+        bool _ringInitialized = false;
+        int _wakeFd = -1;
+        uint64_t _wakeValue = 0;
+        std::atomic<bool> _wakeRequested{ false };
+        std::atomic<bool> _done{ false };
+        // Set under _pendingMutex once the ring has failed.
+        std::atomic<bool> _dead{ false };
+
+        // Only touched by the completion thread.
+        std::unordered_set<FileRead *> _inFlightReads;
+
+        std::mutex _pendingMutex;
+        std::deque<std::unique_ptr<FileRead>> _pendingReads;
+
+        std::thread _thread;
+    };
+
+    IoUringFileReader *getReader()
+    {
+        static std::unique_ptr<IoUringFileReader> pReader = IoUringFileReader::create();
+        return pReader.get();
+    }
+} // namespace
+
+#endif
+
+namespace CesiumForGodot
+{
+    bool readFileWithIoUring( [[maybe_unused]] const std::string &filename,
+                              [[maybe_unused]] FileReadCallback &&callback )
+    {
+#ifdef GODOT_3DTILES_USE_IO_URING
+        IoUringFileReader *pReader = getReader();
+        if ( pReader )
+        {
+            return pReader->read( filename, std::move( callback ) );
+        }
+#endif
+        return false;
+    }
+
+} // namespace CesiumForGodot
@@ -0,0 +1,29 @@
+#ifndef IO_URING_FILE_READER_H
+#define IO_URING_FILE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace CesiumForGodot
+{
+    using FileReadCallback =
+        std::function<void( uint16_t statusCode, std::vector<std::byte> &&data )>;
+
+    /**
+     * Reads a whole local file through a shared Linux io_uring. Reads queued from any thread are
+     * batched into a single submission, and callbacks run on the ring's completion thread with
+     * a 200 or 404 status. The file is opened on the calling thread, so call this from a worker.
+     *
+     * Returns false without calling the callback when io_uring support was not compiled in
+     * (GODOT_3DTILES_USE_IO_URING), the kernel refused to create a ring or the ring has failed,
+     * in which case the caller should read the file some other way. Reads that were already
+     * queued when the ring failed get a status of 0, and should be retried the same way.
+     */
+    bool readFileWithIoUring( const std::string &filename, FileReadCallback &&callback );
+
+} // namespace CesiumForGodot
+
+#endif
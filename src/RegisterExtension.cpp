@@ -9,6 +9,7 @@
 #include "Cesium3DTileset.h"
 #include "CesiumGeoreference.h"
 #include "CesiumOriginAuthority.h"
+#include "CesiumSettings.h"
 #include <Cesium3DTilesContent/registerAllTileContentTypes.h>
 
 /// @file
@@ -36,6 +37,8 @@ namespace
         godot::ClassDB::register_class<CesiumGeoreference>();
         godot::ClassDB::register_class<Cesium3DTileset>();
 
+        Settings::registerProjectSettings();
+
         Cesium3DTilesContent::registerAllTileContentTypes();
     }
 
@@ -1,11 +1,15 @@
 #ifndef THREAD_UTILS_H
 #define THREAD_UTILS_H
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 template <typename T> class threadsafe_queue
 {
@@ -134,63 +138,152 @@ public:
     function_wrapper &operator=( const function_wrapper & ) = delete;
 };
 
+class work_stealing_queue
+{
+private:
+    typedef function_wrapper data_type;
+    std::deque<data_type> the_queue;
+    mutable std::mutex the_mutex;
+
+public:
+    work_stealing_queue()
+    {
+    }
+    work_stealing_queue( const work_stealing_queue &other ) = delete;
+    work_stealing_queue &operator=( const work_stealing_queue &other ) = delete;
+
+    void push( data_type data )
+    {
+        std::lock_guard<std::mutex> lock( the_mutex );
+        the_queue.push_front( std::move( data ) );
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> lock( the_mutex );
+        return the_queue.empty();
+    }
+
+    // The owning thread pops from the front, so freshly spawned subtasks run first while
+    // their data is still hot in cache.
+    bool try_pop( data_type &res )
+    {
+        std::lock_guard<std::mutex> lock( the_mutex );
+        if ( the_queue.empty() )
+        {
+            return false;
+        }
+        res = std::move( the_queue.front() );
+        the_queue.pop_front();
+        return true;
+    }
+
+    // Other threads steal from the back, which holds the oldest (and usually largest) work.
+    bool try_steal( data_type &res )
+    {
+        std::lock_guard<std::mutex> lock( the_mutex );
+        if ( the_queue.empty() )
+        {
+            return false;
+        }
+        res = std::move( the_queue.back() );
+        the_queue.pop_back();
+        return true;
+    }
+};
+
 const int32_t NumberOfWorkerThreadsToSpawn = 4;
 /**
-*This works well for simple cases like this, where the tasks are independent. But it’s
-not so good for situations where the tasks depend on other tasks also submitted to the
-thread pool.
-**/
+ * Work-stealing thread pool.
+ *
+ * Work submitted from outside the pool goes to a shared queue. Work submitted from one of the
+ * pool's own threads (a task spawning subtasks) goes to that thread's local queue, where idle
+ * threads can steal it. Threads with nothing to do sleep on a condition variable instead of
+ * spinning.
+ **/
 class thread_pool
 {
+    typedef function_wrapper task_type;
+
     std::atomic_bool done;
-    threadsafe_queue<function_wrapper> work_queue;
+    std::atomic<size_t> pending_tasks;
+    threadsafe_queue<task_type> pool_work_queue;
+    std::vector<std::unique_ptr<work_stealing_queue>> queues;
+    std::mutex wake_mutex;
+    std::condition_variable wake_cond;
     std::vector<std::thread> threads;
     join_threads joiner;
-    void worker_thread()
+
+    static inline thread_local thread_pool *local_pool = nullptr;
+    static inline thread_local work_stealing_queue *local_work_queue = nullptr;
+    static inline thread_local unsigned my_index = 0;
+
+    void worker_thread( unsigned my_index_ )
     {
+        my_index = my_index_;
+        local_pool = this;
+        local_work_queue = queues[my_index].get();
         while ( !done )
         {
-            function_wrapper task;
-            if ( work_queue.try_pop( task ) )
+            if ( !run_pending_task() )
             {
-                task();
+                std::unique_lock<std::mutex> lk( wake_mutex );
+                wake_cond.wait( lk, [this] { return done || pending_tasks > 0; } );
             }
-            else
+        }
+    }
+
+    bool pop_task_from_local_queue( task_type &task )
+    {
+        return local_pool == this && local_work_queue && local_work_queue->try_pop( task );
+    }
+
+    bool pop_task_from_pool_queue( task_type &task )
+    {
+        return pool_work_queue.try_pop( task );
+    }
+
+    bool pop_task_from_other_thread_queue( task_type &task )
+    {
+        const unsigned start = local_pool == this ? my_index + 1 : 0;
+        for ( unsigned i = 0; i < queues.size(); ++i )
+        {
+            const unsigned index = ( start + i ) % queues.size();
+            if ( queues[index]->try_steal( task ) )
             {
-                std::this_thread::yield();
+                return true;
             }
         }
+        return false;
+    }
+
+    void notify_work_available()
+    {
+        {
+            // Taking the lock orders this notification after a sleeping worker's predicate check.
+            std::lock_guard<std::mutex> lk( wake_mutex );
+        }
+        wake_cond.notify_one();
     }
 
 public:
-    thread_pool() : done( false ), joiner( threads )
+    thread_pool() : done( false ), pending_tasks( 0 ), joiner( threads )
     {
         initialize( 0 );
     }
-    thread_pool( unsigned custom_thread_count ) : done( false ), joiner( threads )
+    thread_pool( unsigned custom_thread_count ) :
+        done( false ), pending_tasks( 0 ), joiner( threads )
     {
         initialize( custom_thread_count );
     }
     void initialize( unsigned custom_thread_count )
     {
-        unsigned const sys_thread_count = std::thread::hardware_concurrency();
-        unsigned thread_count;
-        if ( custom_thread_count )
+        unsigned thread_count = custom_thread_count;
+        if ( !thread_count )
         {
-            if ( sys_thread_count < 2 )
-            {
-                thread_count = 1;
-            }
-            else if ( sys_thread_count > custom_thread_count )
-            {
-                thread_count = custom_thread_count > 2 ? custom_thread_count : 2;
-            }
-            else
-            {
-                thread_count = sys_thread_count;
-            }
+            thread_count = std::thread::hardware_concurrency();
         }
-        else
+        if ( !thread_count )
         {
             thread_count = NumberOfWorkerThreadsToSpawn;
         }
@@ -198,23 +291,66 @@ public:
         {
             for ( unsigned i = 0; i < thread_count; ++i )
             {
-                threads.push_back( std::thread( &thread_pool::worker_thread, this ) );
+                queues.push_back( std::make_unique<work_stealing_queue>() );
+            }
+            for ( unsigned i = 0; i < thread_count; ++i )
+            {
+                threads.push_back( std::thread( &thread_pool::worker_thread, this, i ) );
             }
         }
         catch ( ... )
         {
             done = true;
+            wake_cond.notify_all();
             throw;
         }
     }
     ~thread_pool()
     {
         done = true;
+        {
+            std::lock_guard<std::mutex> lk( wake_mutex );
+        }
+        wake_cond.notify_all();
     }
+
+    size_t thread_count() const
+    {
+        return threads.size();
+    }
+
     template <typename FunctionType> void enqueueWork( FunctionType f )
     {
-        work_queue.push( std::move( f ) );
+        // Counted before the push, so a worker popping the task right away never takes the
+        // count below the number of queued tasks.
+        pending_tasks.fetch_add( 1 );
+        if ( local_pool == this && local_work_queue )
+        {
+            local_work_queue->push( std::move( f ) );
+        }
+        else
+        {
+            pool_work_queue.push( std::move( f ) );
+        }
+        notify_work_available();
+    }
+
+    /**
+     * Runs one queued task on the calling thread, if any is available. A task waiting on
+     * subtasks it spawned can call this in a loop instead of blocking a worker.
+     */
+    bool run_pending_task()
+    {
+        task_type task;
+        if ( pop_task_from_local_queue( task ) || pop_task_from_pool_queue( task ) ||
+             pop_task_from_other_thread_queue( task ) )
+        {
+            pending_tasks.fetch_sub( 1 );
+            task();
+            return true;
+        }
+        return false;
     }
 };
 
-#endif
\ No newline at end of file
+#endif